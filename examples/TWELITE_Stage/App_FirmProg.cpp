@@ -778,8 +778,12 @@ void App_FirmProg::Screen_ModIdentify::cb_protocol(
 		"SELECT_FLASH",
 		"READ_CHIPID",
 		"READ_MAC_CUSTOM",
-		"FINISH",
-		"FINISH_ERROR"
+		"ERASE_FLASH",
+		"WRITE_FLASH",
+		"VERIFY_BAUD",
+		"VERIFY_FLASH",
+		"COMPARE_FLASH",
+		"ERASE_SECTOR"
 	};
 
 	if (pobj) {
@@ -1177,7 +1181,10 @@ void App_FirmProg::Screen_FileProg::start_protocol() {
 	the_screen	<< crlf << '['
 				<< _firmfile_disp << ']';
 
-	twe_prog.begin(TweProg::BL_PROTOCOL_ERASE_AND_WRITE);
+	twe_prog.set_write_window(sAppData.u8_TWESTG_STAGE_APPWRT_WRITE_WINDOW);
+	twe_prog.begin(TweProg::write_protocol(
+		sAppData.u8_TWESTG_STAGE_APPWRT_WRITE_DIFF != 0,
+		sAppData.u8_TWESTG_STAGE_APPWRT_WRITE_VERIFY != 0));
 
 	_b_protocol = true;
 
@@ -1199,7 +1206,11 @@ void App_FirmProg::Screen_FileProg::cb_protocol(
 		"READ_CHIPID",
 		"READ_MAC_CUSTOM",
 		"ERASE_FLASH",
-		"WRITE_FLASH"
+		"WRITE_FLASH",
+		"VERIFY_BAUD",
+		"VERIFY_FLASH",
+		"COMPARE_FLASH",
+		"ERASE_SECTOR"
 	};
 	
 	if (pobj) {
@@ -1212,6 +1223,14 @@ void App_FirmProg::Screen_FileProg::cb_protocol(
 				scm << crlf << crlf << L"ファームウェアを書き込んでいます..." << crlf;
 				scp << crlf;
 			}
+			else if (cmd == TweProg::E_ST_TWEBLP::VERIFY_FLASH) {
+				scm << crlf << crlf << L"書き込み内容を確認しています..." << crlf;
+				scp << crlf;
+			}
+			else if (cmd == TweProg::E_ST_TWEBLP::COMPARE_FLASH) {
+				scm << crlf << crlf << L"書き込み済みの内容と比較しています..." << crlf;
+				scp << crlf;
+			}
 			else {
 				scp << crlf
 					<< strcmd[(int)cmd]
@@ -1227,7 +1246,9 @@ void App_FirmProg::Screen_FileProg::cb_protocol(
 		}
 		else {
 			const int barmax = 32;
-			if (cmd == TweProg::E_ST_TWEBLP::WRITE_FLASH_FROM_FILE) {
+			if (cmd == TweProg::E_ST_TWEBLP::WRITE_FLASH_FROM_FILE
+				|| cmd == TweProg::E_ST_TWEBLP::VERIFY_FLASH
+				|| cmd == TweProg::E_ST_TWEBLP::COMPARE_FLASH) {
 				int progres = (evarg.get_value() + barmax / 2) / 32; // 0..1023 -> 0..16
 				scm << "\033[G|\033[42;30m"; // line heed
 				for (int i = 0; i < progres && i < barmax; i++)
@@ -235,33 +235,30 @@ void App_Glancer::change_screen_font() {
 	idx++;
 }
 
-// put a byte to parse
-void App_Glancer::parse_a_byte(char_t u8b) {
-	// parse.
-	parse_ascii << u8b;
-
-	// if complete parsing
-	if (parse_ascii) {
-		// output as parser format
-		// the_screen_b << parse_ascii;
-		if (!_b_hold_screen_b) the_screen_b.clear_screen();
-		static int ct;
-		if (!_b_hold_screen_b) the_screen_b << "PKT(" << ct++ << ')';
-
-		// EEPROM TEST
-		auto&& p = parse_ascii.get_payload();
-
-		// 1. identify the packet type
-		auto&& pkt = newTwePacket(parse_ascii.get_payload());
-		if (!_b_hold_screen_b) the_screen_b << ":Typ=" << int(identify_packet_type(pkt));
-
-		if (identify_packet_type(pkt) != E_PKT::PKT_ERROR) {
-			// put information
-			if (!_b_hold_screen_b) the_screen_b
-					<< printfmt(":Lq=%d:Ad=%08X(%02X),Tms=%d"
-						, pkt->common.lqi, pkt->common.src_addr, pkt->common.src_lid, pkt->common.tick);
-
-			// store data into `pal_data'
+// called when parse_ascii has completed a sequence.
+void App_Glancer::process_packet() {
+	// output as parser format
+	// the_screen_b << parse_ascii;
+	if (!_b_hold_screen_b) the_screen_b.clear_screen();
+	static int ct;
+	if (!_b_hold_screen_b) the_screen_b << "PKT(" << ct++ << ')';
+
+	// EEPROM TEST
+	auto&& p = parse_ascii.get_payload();
+
+	// 1. identify the packet type (w/o allocation)
+	TwePacketView pkt_view(parse_ascii.get_payload());
+	if (!_b_hold_screen_b) the_screen_b << ":Typ=" << int(pkt_view.get_type());
+
+	if (pkt_view) {
+		// put information
+		if (!_b_hold_screen_b) the_screen_b
+				<< printfmt(":Lq=%d:Ad=%08X(%02X),Tms=%d"
+					, pkt_view.lqi(), pkt_view.src_addr(), pkt_view.src_lid(), millis());
+
+		// store data into `pal_data' (only packets from end devices are kept)
+		if (pkt_view.src_addr() & 0x80000000) {
+			auto&& pkt = pkt_view.materialize();
 			if (pkt_data.add_entry(pkt)) {
 				// update screen.
 				pkt_data.update_term(pkt, false);
@@ -272,12 +269,12 @@ void App_Glancer::parse_a_byte(char_t u8b) {
 
 // process input
 void App_Glancer::process_input() {
-	int c;
+	uint8_t buf[64];
+	int len;
 
-	// from TWE
-	while (-1 != (c = the_uart_queue.read())) {
-		// pass them to M5 (normal packet analysis)
-		parse_a_byte(char_t(c));
+	// from TWE (pass them to the parser by block)
+	while (0 < (len = the_uart_queue.read(buf, sizeof(buf)))) {
+		parse_ascii.parse(buf, len, [this](AsciiParser&) { process_packet(); });
 	}
 }
 
@@ -329,14 +326,17 @@ void App_Glancer::pkt_data_and_view::update_term_full(spTwePacket pal_upd, bool
 	for (int i = idx_start; i < idx_end && i <= int(_dat.size()); i++) {
 		auto&& spobj = _dat[i - 1];
 
+		// the entries moved by the sort order
+		bool b_moved = (i >= _upd_from && i <= _upd_to);
+
 		// show IDs at head.
-		if (update_all || (spobj && spobj == pal_upd)) {
+		if (update_all || b_moved || (spobj && spobj == pal_upd)) {
 			_trm << printfmt("\033[%d;1H\033[K", i - idx_start + 1) // move cursor and clear the line
 				<< printfmt("%2d:", i); // ID:
 		}
 
 		// skip when the corresponding ID is not updated.
-		if (!spobj || ((update_all == false) && spobj != pal_upd)) continue; // not updated
+		if (!spobj || ((update_all == false) && !b_moved && spobj != pal_upd)) continue; // not updated
 
 		// display sensor data
 		if (identify_packet_type(spobj) != E_PKT::PKT_ERROR) {
@@ -350,6 +350,7 @@ void App_Glancer::pkt_data_and_view::update_term_full(spTwePacket pal_upd, bool
 
 		_trm << "\033[4G"; // move cursor at column 2.
 	}
+	_upd_from = 1; _upd_to = 0;
 
 	// update status line
 	update_status();
@@ -481,21 +482,24 @@ bool App_Glancer::pkt_data_and_view::add_entry(spTwePacket spobj) {
 		&& spobj->common.src_addr & 0x80000000
 	) {
 		bool b_found = false;
-		for (int i = 0; i < _max_entry; i++) {
-			if (spobj->common.src_addr == _dat[i]->common.src_addr) {
-				b_found = true;
-				_dat[i] = spobj;
-				break;
-			}
+		int i = _dat_idx.find(spobj->common.src_addr);
+		if (i >= 0) {
+			b_found = true;
+			_dat[i] = spobj;
 		}
 
 		if (!b_found) {
+			i = int(_dat.size());
+			_dat_idx.insert(spobj->common.src_addr, i);
 			_dat.push_back(spobj);
 			_max_entry = _dat.size();
 
 			b_found = true;
 		}
 
+		// keep the sort order
+		if (_sort_key_applied >= 0) reposition_entry(i);
+
 		if (b_found) {
 			if (_bsolo) {
 				// if solo mode, check the coming packt's id with monitoring id and push it.
@@ -517,50 +521,96 @@ bool App_Glancer::pkt_data_and_view::add_entry(spTwePacket spobj) {
 	return false;
 }
 
+bool App_Glancer::pkt_data_and_view::sort_comp(int key, spTwePacket& a, spTwePacket& b) {
+	switch (key) {
+	case 0: return a->common.src_lid > b->common.src_lid; // LID
+	case 1: return a->common.src_addr > b->common.src_addr; // SID
+	case 2: return a->common.lqi < b->common.lqi; // LQI (bigger first)
+	case 3: return a->common.volt > b->common.volt; // Volt
+	case 4: return a->common.tick < b->common.tick; // Time (bigger first)
+	default: return false;
+	}
+}
+
 void App_Glancer::pkt_data_and_view::sort_entries() {
-	switch (_sort_key) {
-	case 0: // LID
-		SmplBuf_Sort(_dat,
-			[](spTwePacket& a, spTwePacket& b) {
-				return a->common.src_lid > b->common.src_lid;
-			}
-		);
-		break;
+	int key = _sort_key;
+	SmplBuf_Sort(_dat,
+		[key](spTwePacket& a, spTwePacket& b) {
+			return sort_comp(key, a, b);
+		}
+	);
+	_sort_key_applied = key;
 
-	case 1: // SID
-		SmplBuf_Sort(_dat,
-			[](spTwePacket& a, spTwePacket& b) {
-				return a->common.src_addr > b->common.src_addr;
-			}
-		);
-		break;
+	reindex_entries();
 
-	case 2: // LQI
-		SmplBuf_Sort(_dat,
-			[](spTwePacket& a, spTwePacket& b) {
-				return a->common.lqi < b->common.lqi; // bigger first
-			}
-		);
-		break;
+	if (++_sort_key >= _SORT_KEYS_COUNT) _sort_key = 0;
+}
 
-	case 3: // Volt 
-		SmplBuf_Sort(_dat,
-			[](spTwePacket& a, spTwePacket& b) {
-				return a->common.volt > b->common.volt;
-			}
-		);
-		break;
+void App_Glancer::pkt_data_and_view::reindex_entries() {
+	_dat_idx.clear();
+	for (int i = 0; i < int(_dat.size()); i++) {
+		_dat_idx.insert(_dat[i]->common.src_addr, i);
+	}
+}
 
-	case 4: // Time
-		SmplBuf_Sort(_dat,
-			[](spTwePacket& a, spTwePacket& b) {
-				return a->common.tick < b->common.tick; // bigger first
-			}
-		);
-		break;
+/**
+ * @fn	int App_Glancer::pkt_data_and_view::reposition_entry(int i)
+ *
+ * @brief	Moves the updated entry _dat[i] to keep the order of _sort_key_applied
+ * 			(other entries are kept sorted), by binary search and shifting entries between.
+ * 			The moved entries are marked to be redrawn, and the selection follows the entry.
+ *
+ * @param	i	index of the updated entry.
+ *
+ * @returns	The new index of the entry.
+ */
+int App_Glancer::pkt_data_and_view::reposition_entry(int i) {
+	const int key = _sort_key_applied;
+	const int n = int(_dat.size());
+
+	int j = i; // new index
+	if (i > 0 && sort_comp(key, _dat[i - 1], _dat[i])) {
+		// move forward: the first in [0, i) to be placed after it.
+		int lo = 0, hi = i - 1;
+		while (lo < hi) {
+			int m = (lo + hi) / 2;
+			if (sort_comp(key, _dat[m], _dat[i])) hi = m; else lo = m + 1;
+		}
+		j = lo;
 	}
+	else if (i < n - 1 && sort_comp(key, _dat[i], _dat[i + 1])) {
+		// move backward: just before the first in (i, n) to be placed after it.
+		int lo = i + 1, hi = n;
+		while (lo < hi) {
+			int m = (lo + hi) / 2;
+			if (sort_comp(key, _dat[m], _dat[i])) hi = m; else lo = m + 1;
+		}
+		j = lo - 1;
+	}
+	if (j == i) return i;
 
-	if (++_sort_key >= _SORT_KEYS_COUNT) _sort_key = 0;
+	// shift entries between
+	spTwePacket obj = as_moving(_dat[i]);
+	if (j < i) {
+		for (int k = i; k > j; k--) _dat[k] = as_moving(_dat[k - 1]);
+	}
+	else {
+		for (int k = i; k < j; k++) _dat[k] = as_moving(_dat[k + 1]);
+	}
+	_dat[j] = as_moving(obj);
+
+	int k0 = std::min(i, j), k1 = std::max(i, j);
+	for (int k = k0; k <= k1; k++) _dat_idx.insert(_dat[k]->common.src_addr, k);
+
+	// the selection follows the entry (_nsel is 1..max_entry)
+	if (_nsel == i + 1) _nsel = j + 1;
+	else if (_nsel >= k0 + 1 && _nsel <= k1 + 1) _nsel += (j < i) ? 1 : -1;
+
+	// redraw moved entries
+	if (_upd_from > _upd_to) { _upd_from = k0 + 1; _upd_to = k1 + 1; }
+	else { _upd_from = std::min(_upd_from, k0 + 1); _upd_to = std::max(_upd_to, k1 + 1); }
+
+	return j;
 }
 
 void App_Glancer::pkt_data_and_view::enter_solo_mode() {
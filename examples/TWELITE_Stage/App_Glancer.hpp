@@ -22,6 +22,7 @@ public:
 	 */
 	struct pkt_data_and_view {
 		pkt_ary _dat;
+		TWEUTILS::HashIndex _dat_idx; // src_addr -> index of _dat
 		FixedQueue<spTwePacket> _dat_solo;
 
 		int _page;      // start from 0
@@ -35,6 +36,9 @@ public:
 		bool _bsolo;	// solo display mode
 
 		int _sort_key;  // 0:SID, 1:LID, 2:LQI, 3:VOLT 4:TIME
+		int _sort_key_applied; // the sort order kept in _dat (-1: not sorted)
+
+		int _upd_from, _upd_to; // entries to be redrawn, other than the coming one (1..max_entry)
 
 		struct {
 			uint32_t src_addr;
@@ -52,6 +56,7 @@ public:
 
 		pkt_data_and_view(ITerm& trm, ITerm& trm_status) 
 			: _dat(8) // initial reserve
+			, _dat_idx(8)
 			, _dat_solo(32)
 			, _page(0)
 			, _lines(0)
@@ -64,6 +69,8 @@ public:
 			, _nsel(0)
 			, _solo_info{}
 			, _sort_key(0)
+			, _sort_key_applied(-1)
+			, _upd_from(1), _upd_to(0)
 		{}
 
 		// screen init
@@ -78,6 +85,12 @@ public:
 		// add coming packet entry
 		bool add_entry(spTwePacket spobj);
 
+		// build _dat_idx again (after _dat is reordered)
+		void reindex_entries();
+
+		// move the updated entry to keep the sort order, returns new index
+		int reposition_entry(int i);
+
 		// show next page
 		void next_page() {
 			_page++;
@@ -154,6 +167,9 @@ public:
 		// sort the lists
 		void sort_entries();
 
+		// true if a shall be placed after b by the sort key
+		static bool sort_comp(int key, spTwePacket& a, spTwePacket& b);
+
 		// solo mode
 		void enter_solo_mode();
 
@@ -212,7 +228,7 @@ public:
 
 
 private:
-	void parse_a_byte(char_t u8b);
+	void process_packet();
 	void process_input();
 	void check_for_serial();
 
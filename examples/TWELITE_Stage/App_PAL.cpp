@@ -76,10 +76,7 @@ void App_PAL::loop() {
 				pkt_data.set_page(1);
 
 				const char* p = paldata[s_idx];
-				while (*p != 0) {
-					parse_a_byte(char_t(*p));
-					p++;
-				}
+				parse_ascii.parse((const uint8_t*)p, strlen(p), [this](AsciiParser&) { process_packet(); });
 
 				pkt_data.update_term();
 
@@ -180,38 +177,35 @@ void App_PAL::change_screen_font() {
 	idx++;
 }
 
-// put a byte to parse
-void App_PAL::parse_a_byte(char_t u8b) {
-	// parse.
-	parse_ascii << u8b;
-
-	// if complete parsing
-	if (parse_ascii) {
-		// output as parser format
-		// the_screen_b << parse_ascii;
-		the_screen_b.clear_screen();
-		static int ct;
-		the_screen_b << "PKT(" << ct++ << ')';
-
-		// EEPROM TEST
-		auto&& p = parse_ascii.get_payload();
-
-		// 1. identify the packet type
-		auto&& pkt = newTwePacket(parse_ascii.get_payload());
-		the_screen_b << ":Typ=" << int(identify_packet_type(pkt));
-
-		if (identify_packet_type(pkt) == E_PKT::PKT_PAL) {
-			auto&& pal = refTwePacketPal(pkt);
-
-			// put information
-			the_screen_b
-				<< printfmt(":Lq=%d:Ad=%08X", pal.u8lqi, pal.u32addr_src)
-				<< ":PAL=" << int(pal.u8palpcb)
-				<< ":ID=" << int(pal.u8addr_src)
-				<< ":Dat=" << int(pal.u8sensors)
-				;
-
-			// store data into `pal_data'
+// called when parse_ascii has completed a sequence.
+void App_PAL::process_packet() {
+	// output as parser format
+	// the_screen_b << parse_ascii;
+	the_screen_b.clear_screen();
+	static int ct;
+	the_screen_b << "PKT(" << ct++ << ')';
+
+	// EEPROM TEST
+	auto&& p = parse_ascii.get_payload();
+
+	// 1. identify the packet type (w/o allocation)
+	TwePacketView pkt_view(parse_ascii.get_payload());
+	the_screen_b << ":Typ=" << int(pkt_view.get_type());
+
+	if (pkt_view.get_type() == E_PKT::PKT_PAL) {
+		PalView pal(pkt_view);
+
+		// put information
+		the_screen_b
+			<< printfmt(":Lq=%d:Ad=%08X", pal.u8lqi(), pal.u32addr_src())
+			<< ":PAL=" << int(pal.u8palpcb())
+			<< ":ID=" << int(pal.u8addr_src())
+			<< ":Dat=" << int(pal.u8sensors())
+			;
+
+		// store data into `pal_data'
+		if (pal.u8addr_src() >= 1 && pal.u8addr_src() <= pkt_data._siz) {
+			auto&& pkt = pal.materialize();
 			if (pkt_data.add_entry(pkt)) {
 				// update screen.
 				pkt_data.update_term(pkt, false);
@@ -222,12 +216,12 @@ void App_PAL::parse_a_byte(char_t u8b) {
 
 // process input
 void App_PAL::process_input() {
-	int c;
+	uint8_t buf[64];
+	int len;
 
-	// from TWE
-	while (-1 != (c = the_uart_queue.read())) {
-		// pass them to M5 (normal packet analysis)
-		parse_a_byte(char_t(c));
+	// from TWE (pass them to the parser by block)
+	while (0 < (len = the_uart_queue.read(buf, sizeof(buf)))) {
+		parse_ascii.parse(buf, len, [this](AsciiParser&) { process_packet(); });
 	}
 }
 
@@ -137,7 +137,7 @@ public:
 	void loop();
 
 private:
-	void parse_a_byte(char_t u8b);
+	void process_packet();
 	void process_input();
 	void check_for_serial();
 
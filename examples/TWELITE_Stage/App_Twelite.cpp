@@ -71,10 +71,7 @@ void App_TweLite::loop() {
 				if (s_idx >= 3) s_idx = 0;
 
 				const char* p = pktdata[s_idx];
-				while (*p != 0) {
-					parse_a_byte(char_t(*p));
-					p++;
-				}
+				parse_ascii.parse((const uint8_t*)p, strlen(p), [this](AsciiParser&) { process_packet(); });
 
 				the_screen_b.clear_screen();
 				the_screen_b << "TEST DATA: " << msgs[s_idx];
@@ -258,51 +255,45 @@ void App_TweLite::update_screen(bool b_redraw ) {
 	}
 }
 
-// put a byte to parse
-void App_TweLite::parse_a_byte(char_t u8b) {
-	// parse.
-	parse_ascii << u8b;
-
-	// if complete parsing
-	if (parse_ascii) {
-		// output as parser format
-		// the_screen_b << parse_ascii;
-		the_screen_b.clear_screen();
-		static int ct;
-		the_screen_b << "PKT(" << ct++ << ')';
+// called when parse_ascii has completed a sequence.
+void App_TweLite::process_packet() {
+	// output as parser format
+	// the_screen_b << parse_ascii;
+	the_screen_b.clear_screen();
+	static int ct;
+	the_screen_b << "PKT(" << ct++ << ')';
 
-		// EEPROM TEST
-		auto&& p = parse_ascii.get_payload();
+	// EEPROM TEST
+	auto&& p = parse_ascii.get_payload();
 
-		// 1. identify the packet type
-		auto&& pkt = newTwePacket(parse_ascii.get_payload());
-		the_screen_b << ":Typ=" << int(identify_packet_type(pkt));
+	// 1. identify the packet type (w/o allocation)
+	TwePacketView pkt_view(parse_ascii.get_payload());
+	the_screen_b << ":Typ=" << int(pkt_view.get_type());
 
-		if (identify_packet_type(pkt) == E_PKT::PKT_TWELITE) {
-			auto&& x = refTwePacketTwelite(pkt);
+	if (pkt_view.get_type() == E_PKT::PKT_TWELITE) {
+		TweliteView x(pkt_view);
 
-			// put information
-			the_screen_b
-				<< printfmt(":Lq=%d:Ad=%08X", x.u8lqi, x.u32addr_src)
-				<< printfmt(":ID=%02X", x.u8addr_src)
-				<< printfmt(":DI=%04b", x.DI_mask)
-				;
+		// put information
+		the_screen_b
+			<< printfmt(":Lq=%d:Ad=%08X", x.u8lqi(), x.u32addr_src())
+			<< printfmt(":ID=%02X", x.u8addr_src())
+			<< printfmt(":DI=%04b", x.DI_mask())
+			;
 
-			spLastPacket = pkt;
+		spLastPacket = x.materialize();
 
-			update_screen();
-		}
+		update_screen();
 	}
 }
 
 // process input
 void App_TweLite::process_input() {
-	int c;
+	uint8_t buf[64];
+	int len;
 
-	// from TWE
-	while (-1 != (c = the_uart_queue.read())) {
-		// pass them to M5 (normal packet analysis)
-		parse_a_byte(char_t(c));
+	// from TWE (pass them to the parser by block)
+	while (0 < (len = the_uart_queue.read(buf, sizeof(buf)))) {
+		parse_ascii.parse(buf, len, [this](AsciiParser&) { process_packet(); });
 	}
 }
 
@@ -61,7 +61,7 @@ public:
 
 private:
 	void update_screen(bool b_redraw = false);
-	void parse_a_byte(char_t u8b);
+	void process_packet();
 	void process_input();
 	void check_for_serial();
 
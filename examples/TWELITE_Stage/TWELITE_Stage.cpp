@@ -20,6 +20,7 @@
 # include <PS2Keyboard.h> // https://www.pjrc.com/teensy/td_libs_PS2Keyboard.html
 #elif defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
 #include "App_SelectPort.hpp"
+#include "serial_capture.hpp"
 #endif
 
 #include "common.h"
@@ -228,17 +229,38 @@ static void s_check_serial() {
 	}
 	
 #ifdef IDF_UART
-	// UART2 : connected to TWE
-	while (Serial2_IDF.available()) {
-		int c = Serial2_IDF.read();
-		if (c >= 0) the_uart_queue.push(c);
+	// UART2 : connected to TWE (chunks received by the RX task)
+	uint8_t buf[128];
+	int n;
+	while ((n = Serial2_IDF.read(buf, sizeof(buf))) > 0) {
+		the_uart_queue.push(buf, n);
 	}
 #else
+	// replay of a capture file (as if received from TWE, fed by the_replay.update() in the main loop)
+	if (the_replay.is_opened()) {
+		while (the_replay.available()) {
+			int c = the_replay.read();
+			if (c >= 0) the_uart_queue.push(c);
+		}
+	}
+
 	// UART2 : connected to TWE
+	uint8_t buf[256];
+	int n = 0;
 	while (Serial2.available()) {
 		int c = Serial2.read();
-		if (c >= 0) the_uart_queue.push(c);
+		if (c >= 0) {
+			the_uart_queue.push(c);
+
+			// record them into the capture file
+			buf[n++] = uint8_t(c);
+			if (n == sizeof(buf)) {
+				the_capture.write(buf, n);
+				n = 0;
+			}
+		}
 	}
+	if (n > 0) the_capture.write(buf, n);
 #endif
 }
 
@@ -21,6 +21,9 @@ struct _sAppData {
 	uint8_t u8_TWESTG_STAGE_APPWRT_BUILD_MAKE_JOGS;
 #endif
 	uint8_t u8_TWESTG_STAGE_APPWRT_BUILD_NEXT_SCREEN;
+	uint8_t u8_TWESTG_STAGE_APPWRT_WRITE_WINDOW;
+	uint8_t u8_TWESTG_STAGE_APPWRT_WRITE_VERIFY;
+	uint8_t u8_TWESTG_STAGE_APPWRT_WRITE_DIFF;
 };
 
 extern struct _sAppData sAppData;
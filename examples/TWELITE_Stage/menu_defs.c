@@ -101,6 +101,32 @@ const TWESTG_tsElement TWESTG_SLOT_SCREEN_BUILD[] = {
 		  "1: ターミナル画面にします。" },
 		{ E_TWEINPUTSTRING_DATATYPE_DEC, 2, 'n' },
 		{ {.u32 = 0}, {.u32 = 1}, TWESTGS_VLD_u32MinMax, NULL } },
+	{ E_TWESTG_STAGE_APPWRT_WRITE_WINDOW,
+		{ TWESTG_DATATYPE_UINT8, sizeof(uint8), 0, 0, {.u8 = 1 }},
+		{ "WIN", "書込み時の先行送信数",
+		  "応答を待たずに送る書込み要求の数です(1..4)\r\n"
+		  "1: 既定値で応答ごとに次を送ります。\r\n"
+		  "2以上: 書込みが速くなりますが、取りこぼす\r\n"
+		  "  モジュール・アダプタでは失敗します。" },
+		{ E_TWEINPUTSTRING_DATATYPE_DEC, 1, 'w' },
+		{ {.u32 = 1}, {.u32 = 4}, TWESTGS_VLD_u32MinMax, NULL } },
+	{ E_TWESTG_STAGE_APPWRT_WRITE_VERIFY,
+		{ TWESTG_DATATYPE_UINT8, sizeof(uint8), 0, 0, {.u8 = 1 }},
+		{ "VRF", "書込み後の確認",
+		  "書込み後に読み出して内容を確認します\r\n"
+		  "0: 確認しません。\r\n"
+		  "1: 既定値で確認します。" },
+		{ E_TWEINPUTSTRING_DATATYPE_DEC, 1, 'v' },
+		{ {.u32 = 0}, {.u32 = 1}, TWESTGS_VLD_u32MinMax, NULL } },
+	{ E_TWESTG_STAGE_APPWRT_WRITE_DIFF,
+		{ TWESTG_DATATYPE_UINT8, sizeof(uint8), 0, 0, {.u8 = 0 }},
+		{ "DIF", "差分書込み",
+		  "書込み済みの内容と比較して異なるセクタ\r\n"
+		  "(32KB)だけを消去・書込みします\r\n"
+		  "0: 既定値で全体を消去・書込みします。\r\n"
+		  "1: 差分書込みします。" },
+		{ E_TWEINPUTSTRING_DATATYPE_DEC, 1, 'd' },
+		{ {.u32 = 0}, {.u32 = 1}, TWESTGS_VLD_u32MinMax, NULL } },
 	{E_TWESTG_DEFSETS_VOID}
 };
 
@@ -25,6 +25,9 @@ typedef enum {
 #ifndef ESP32
 	E_TWESTG_STAGE_APPWRT_BUILD_MAKE_JOGS,
 #endif
+	E_TWESTG_STAGE_APPWRT_WRITE_WINDOW = 0x38,
+	E_TWESTG_STAGE_APPWRT_WRITE_VERIFY,
+	E_TWESTG_STAGE_APPWRT_WRITE_DIFF,
 	// INTRCT
 #ifdef ESP32
 	E_TWESTG_STAGE_INTRCT_START = 0x40,
@@ -15,14 +15,18 @@ APPSRC_CXX+=$(OSNAME)/linux_term.cpp
 #####################################################################
 # ADDITIONAL INCLUDE PATH
 INCFLAGS += -I$(root_dir)/linux/lib/FTDI
+ifneq ($(HEADLESS),1)
 INCFLAGS += -I$(root_dir)/linux/lib/SDL2/include
+endif
 INCFLAGS += -I$(root_dir)/src/$(OSNAME)
 
 #####################################################################
 # LIBRARY
 
 # SDL2
+ifneq ($(HEADLESS),1)
 LDFLAGS += -L$(root_dir)/linux/lib/SDL2/lib/
+endif
 CFLAGS += -D_REENTRANT
 
 # FTDI D2XX
@@ -30,7 +34,9 @@ LDFLAGS += -L$(root_dir)/linux/lib/FTDI/
 
 ifeq ($(DO_DYNAMIC_LINK),1)
 # build normally
+ifneq ($(HEADLESS),1)
 ADDITIONAL_LIBS += -lSDL2
+endif
 ADDITIONAL_LIBS += -lftd2xx
 else
 # static build
@@ -38,9 +44,11 @@ ADDITIONAL_LIBS += -static-libstdc++ -static-libgcc
 ADDITIONAL_LIBS += $(root_dir)/linux/lib/FTDI/libftd2xx.a
 
 #ADDITIONAL_LIBS += $(root_dir)/linux/lib/SDL2/lib/libSDL2.a -Wl,--no-undefined -lm -ldl -lasound -lm -ldl -lpthread -lpulse-simple -lpulse -lsndio -lX11 -lXext -lXcursor -lXinerama -lXi -lXrandr -lXss -lXxf86vm -lwayland-egl -lwayland-client -lwayland-cursor -lxkbcommon
+ifneq ($(HEADLESS),1)
 ADDITIONAL_LIBS += $(root_dir)/linux/lib/SDL2/lib/libSDL2.a -Wl,--no-undefined -lm -ldl -lasound -lm -ldl -lpthread -lpulse-simple -lpulse -lX11 -lXext -lXcursor -lXinerama -lXi -lXrandr -lXss -lXxf86vm -lwayland-egl -lwayland-client -lwayland-cursor -lxkbcommon
 ADDITIONAL_LIBS += $(root_dir)/linux/lib/sndio/libsndio.a
 endif
+endif
 
 # common for SDL2/FTDI
 ADDITIONAL_LIBS +=  -lpthread -lrt
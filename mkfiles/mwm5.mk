@@ -15,6 +15,9 @@ MWM5=1
 # makefile's debug message.
 DEBUGINFO?=0
 
+# headless build (HEADLESS=1)
+HEADLESS?=0
+
 # target type (suffix) is set in arch_???.mk
 TARGET_TYPE ?= bin
 
@@ -113,13 +116,21 @@ APPSRC+=twesettings/tweserial_jen.c
 APPSRC+=twesettings/tweinteractive.c
 APPSRC+=twesettings/twesettings_std_defsets.c
 
+ifeq ($(HEADLESS),1)
+# headless build (no SDL, the LCD is a null sink)
+CFLAGS += -DMWM5_HEADLESS
+APPSRC_CXX+=gen/headless_main.cpp
+else
 APPSRC_CXX+=gen/sdl2_main.cpp
 APPSRC_CXX+=gen/sdl2_keyb.cpp
 APPSRC_CXX+=gen/sdl2_clipboard.cpp
 APPSRC_CXX+=gen/sdl2_button.cpp
 APPSRC_CXX+=gen/sdl2_icon.cpp
+endif
 APPSRC_CXX+=gen/serial_ftdi.cpp
 APPSRC_CXX+=gen/modctrl_ftdi.cpp
+APPSRC_CXX+=gen/serial_capture.cpp
+APPSRC_CXX+=gen/batch_prog.cpp
 
 # thanks to open source contributions!
 APPSRC+=printf/printf.c
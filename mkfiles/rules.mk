@@ -8,6 +8,7 @@
 ##############################################################################
 # VERSION
 NAME_DEBUG_SUFF=debug
+NAME_HEADLESS_SUFF=headless
 NAME_OBJDIR=objs
 
 ##############################################################################
@@ -36,6 +37,9 @@ else
 #TARGET_BIN = $(TARGET)_$(VERSION_MAIN)-$(VERSION_SUB)-$(VERSION_VAR)
 TARGET_BIN = $(TARGET)
 endif
+ifeq ($(HEADLESS),1)
+TARGET_BIN := $(TARGET_BIN)-$(NAME_HEADLESS_SUFF)
+endif
 CFLAGS += -DSTR_MWM5_APP_NAME=\"$(TARGET_DIR)\"
 
 ##############################################################################
@@ -49,6 +53,9 @@ OBJDIR   = $(NAME_OBJDIR)-$(NAME_DEBUG_SUFF)
 else
 OBJDIR   = $(NAME_OBJDIR)
 endif
+ifeq ($(HEADLESS),1)
+OBJDIR  := $(OBJDIR)-$(NAME_HEADLESS_SUFF)
+endif
 
 ##############################################################################
 # Objects
@@ -190,5 +197,6 @@ objdir:
 # note: clean/cleanall will keep a target `.bin' file.
 clean:
 	@rm -rfv $(NAME_OBJDIR) $(NAME_OBJDIR)-$(NAME_DEBUG_SUFF)
+	@rm -rfv $(NAME_OBJDIR)-$(NAME_HEADLESS_SUFF) $(NAME_OBJDIR)-$(NAME_DEBUG_SUFF)-$(NAME_HEADLESS_SUFF)
 
 #########################################################################
@@ -53,39 +53,55 @@ namespace TWEARD {
 	}
 
 	/// <summary>
-	/// draw a char in LCD (M5stack)
+	/// glyph size in pixels (as rendered by s_render_glyph()).
+	/// </summary>
+	static inline void s_glyph_size(const TWEFONT::FontDef& font, bool wide, int& w, int& h) {
+		bool yokobai = (font.opt & TWEFONT::U32_OPT_FONT_YOKOBAI);
+		bool tatebai = (font.opt & TWEFONT::U32_OPT_FONT_TATEBAI);
+
+		w = (font.width + font.w_space) * (wide ? 2 : 1) * (yokobai ? 2 : 1);
+		h = font.height * (tatebai ? 2 : 1) + font.h_space;
+	}
+
+	/// <summary>
+	/// glyph output to LCD window (setWindow() by each row, then windowWrite16()).
+	/// </summary>
+	struct _GlyphSinkLcd {
+		M5Stack& _M5;
+		int32_t x, y, w;
+
+		inline void row(int n) { setWindow(x, y + n, x + w - 1, y + n + 1, _M5); } // y is actual font height, x is font width -1
+		inline void put(uint16_t c) { windowWrite16(c, _M5); }
+	};
+
+	/// <summary>
+	/// glyph output to a pixel buffer (row-major, stored as PIX).
+	/// </summary>
+	static inline void s_to_pix(uint16_t c, uint16_t& d) { d = c; }
+	static inline void s_to_pix(uint16_t c, RGBA& d) { d = color565toRGBA(c); }
+
+	template <typename PIX>
+	struct _GlyphSinkBuf {
+		PIX* p;
+
+		inline void row(int n) {}
+		inline void put(uint16_t c) { s_to_pix(c, *p++); }
+	};
+
+	/// <summary>
+	/// render a char (except the default font) to the sink.
 	/// 
-	/// Note: setWindow() does not allow bigger area (maybe > 256bytes).
-	///       it should be set row by row when drawing a bigger char.
+	/// Note: the sink gets row(n) at the start of each row, followed by put() of each pixel.
+	///       pixels are put in row-major order of the size s_glyph_size() tells.
 	/// </summary>
-	/// <param name="x"></param>
-	/// <param name="y"></param>
+	/// <param name="font"></param>
 	/// <param name="c">drawing character (UNICODE)</param>
 	/// <param name="color"></param>
 	/// <param name="bg"></param>
-	/// <param name="opt">
-	///   MASK 0x01 : render bold style.
-	/// </param>
-	/// <returns></returns>
-	int16_t drawChar(const TWEFONT::FontDef& font, int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t opt, M5Stack& _M5) {
-		// check if default font. 
-		if (font.is_default()) {
-			// (maybe this code is unexpected)
-
-#if defined(ESP32)
-			if (TWEUTILS::Unicode_isSingleWidth(c) && c < 0x80) {
-				M5.Lcd.drawChar(x, y, c, color, bg, 1);
-			}
-			else {
-				M5.Lcd.drawChar(x, y, '#', bg, color, 1); // write something
-			}
-
-			return font.get_width();
-#elif defined (_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
-			return 0;
-#endif
-		}
-
+	/// <param name="opt">see drawChar()</param>
+	/// <param name="out">the sink</param>
+	template <class SINK>
+	static void s_render_glyph(const TWEFONT::FontDef& font, uint16_t c, uint16_t color, uint16_t bg, uint8_t opt, SINK& out) {
 		// check bold option
 		bool bold = ((opt & 0x01) == 0x01); // if true, draw with bold style
 		bool underline = ((opt & 0x02) == 0x02); // if true draw underline
@@ -93,10 +109,6 @@ namespace TWEARD {
 		int cursor_rows = font.height / 2 - 1; // cursor start row
 		int underline_rows = font.height - 2; // underline start row 
 
-#ifdef DEBUGSER
-		Serial.printf("(%d:%04x", font.get_font_code(), c);
-#endif
-
 		if (TWEUTILS::Unicode_isSingleWidth(c)) {
 			// render single width chars
 
@@ -111,17 +123,11 @@ namespace TWEARD {
 
 
 			if (!(font.opt & TWEFONT::U32_OPT_FONT_TATEBAI || font.opt & TWEFONT::U32_OPT_FONT_YOKOBAI)) {
-				// do render
-				startWrite(_M5);
-
 				// DO NOT USE setWindow() for whole character, but set to one row.
-				// M5.Lcd.setWindow(x, y, x + font.width + font.w_space - 1, y + font.height + font.h_space); // y is actual font height, x is font width -1
-
 				int i;
-				int w = font.width + font.w_space;
 				uint16_t col;
 				for (i = 0; i < font.data_rows && i < font.height; i++) {
-					setWindow(x, y + i, x + w - 1, y + i + 1, _M5); // y is actual font height, x is font width -1
+					out.row(i);
 					
 					int32_t col_force = get_color_force(i, cursor, cursor_rows, RED, underline, underline_rows, color);
 					
@@ -133,12 +139,12 @@ namespace TWEARD {
 						uint8_t bit = (pat & 0x80);
 						
 						col = (col_force == -1) ? (bit ? color : bg) : (bit ? BLACK : col_force);
-						windowWrite16(col, _M5);
+						out.put(col);
 					}
 
 					col = (col_force >= 0) ? bg : col_force;
 					for (; j < font.width + font.w_space; j++) {
-						windowWrite16(col, _M5);
+						out.put(col);
 					}
 				}
 
@@ -147,36 +153,24 @@ namespace TWEARD {
 					int32_t col_force = get_color_force(i, cursor, cursor_rows, RED, underline, underline_rows, color);
 					col = col_force == -1 ? bg : col_force;
 
-					setWindow(x, y + i, x + w - 1, y + i + 1, _M5); // y is actual font height, x is font width -1
+					out.row(i);
 					for (int j = 0; j < font.width + font.w_space; j++) {
-						windowWrite16(col, _M5);
+						out.put(col);
 					}
 				}
-
-				endWrite(_M5);
 			}
 			else {
 				// Double size.
 				bool yokobai = (font.opt & TWEFONT::U32_OPT_FONT_YOKOBAI);
 				bool tatebai = (font.opt & TWEFONT::U32_OPT_FONT_TATEBAI);
 
-				int w = 0;
-				if (yokobai) w = (font.width + font.w_space) * 2;
-				else w = (font.width + font.w_space);
-
-				int h = 0;
-				if (tatebai) h = font.height * 2;
-				else h = font.height;
-
-				// do render
-				startWrite(_M5);
 				int i;
 				int nLine = 0;
 				uint16_t col1, col2;
 				for (i = 0; i < font.height; i++) {
 					int tate_ct = tatebai ? 2 : 1;
 					while (tate_ct--) {
-						setWindow(x, y + nLine, x + w - 1, y + nLine + 1, _M5); // y is actual font height, x is font width -1
+						out.row(nLine);
 
 						uint8_t pat = (i < font.data_rows) ? p[i] : 0;
 						uint16_t last_bit = 0;
@@ -194,9 +188,9 @@ namespace TWEARD {
 								col1 = (bold && last_bit ? color : col2);
 							}
 
-							windowWrite16(col1, _M5);
+							out.put(col1);
 							if (yokobai) {
-								windowWrite16(col2, _M5);
+								out.put(col2);
 							}
 							last_bit = bit;
 						}
@@ -210,9 +204,9 @@ namespace TWEARD {
 							col2 = col1;
 						}
 						for (; j < (font.width + font.w_space); j++) {
-							windowWrite16(col1, _M5);
+							out.put(col1);
 							if (yokobai) {
-								windowWrite16(col2, _M5);
+								out.put(col2);
 							}
 						}
 						nLine++;
@@ -223,43 +217,29 @@ namespace TWEARD {
 				col1 = cursor ? RED : bg;
 				col2 = col1;
 				for (; i < font.height + font.h_space; i++) {
-					setWindow(x, y + nLine, x + w - 1, y + nLine + 1, _M5); // y is actual font height, x is font width -1
+					out.row(nLine);
 					for (int j = 0; j < font.width + font.w_space; j++) {
-						windowWrite16(col1, _M5);
+						out.put(col1);
 						if (yokobai) {
-							windowWrite16(col2, _M5);
+							out.put(col2);
 						}
 					}
 					nLine++;
 				}
-				endWrite(_M5);
 			}
-			
-#ifdef DEBUGSER
-			Serial.printf(")", c);
-#endif
-
-			return font.get_width();
 		}
 		else {
-			// check wide char font data presence.
-			if (font.font_wide == nullptr) return 0; // nurupo check
-
 			// find font data (only assuming 16bit width)
 			const uint8_t* p = font.font_wide_missing;
 			int idx = font.find_font_index(c); // find index to unicode bitmap data by charcode.
 			if (idx >= 0) p = &font.font_wide[idx * font.data_rows * 2]; // find from the table
 
-#ifdef DEBUGSER
-			Serial.printf("->%d)", idx);
-#endif
 			if (!(font.opt & TWEFONT::U32_OPT_FONT_TATEBAI || font.opt & TWEFONT::U32_OPT_FONT_YOKOBAI)) {
-				// do render
-				startWrite(_M5);
-				setWindow(x, y, x + ((font.width + font.w_space) * 2 - 1), y + font.height + font.h_space, _M5); // y is actual font height, x is font width -1
 				int i;
 				uint16_t col;
 				for (i = 0;  i < font.height; i++) {
+					out.row(i);
+
 					uint16_t pat = i < font.data_rows ? ((p[i*2] << 8) | p[i*2+1]) : 0; // if you need >16dot font, you need edit here to expand bit width.
 					if (bold) pat = pat | (pat >> 1);
 
@@ -270,12 +250,12 @@ namespace TWEARD {
 						uint16_t bit = (pat & 0x8000);
 
 						col = col_force == -1 ? (bit ? color : bg) : (bit ? BLACK : col_force);
-						windowWrite16(col, _M5);
+						out.put(col);
 					}
 
 					col = col_force == -1 ? bg : col_force;
 					for (; j < (font.width + font.w_space) * 2; j++) {
-						windowWrite16(col, _M5);
+						out.put(col);
 					}
 				}
 				
@@ -284,26 +264,16 @@ namespace TWEARD {
 					int32_t col_force = get_color_force(i, cursor, cursor_rows, RED, underline, underline_rows, color);
 					col = col_force == -1 ? bg : col_force;
 					
+					out.row(i);
 					for (int j = 0; j < (font.width + font.w_space) * 2; j++) {
-						windowWrite16(col, _M5);
+						out.put(col);
 					}
 				}
-				endWrite(_M5);
 			}
 			else {
 				bool yokobai = (font.opt & TWEFONT::U32_OPT_FONT_YOKOBAI);
 				bool tatebai = (font.opt & TWEFONT::U32_OPT_FONT_TATEBAI);
 				
-				int w = 0;
-				if (yokobai) w = (font.width + font.w_space) * 4;
-				else w = (font.width + font.w_space) * 2;
-
-				int h = 0;
-				if (tatebai) h = font.height * 2;
-				else h = font.height;
-
-				// do render
-				startWrite(_M5);
 				int i;
 				int nLine = 0;
 
@@ -311,7 +281,7 @@ namespace TWEARD {
 				for (i = 0; i < font.height; i++) {
 					int tate_ct = tatebai ? 2 : 1;
 					while (tate_ct--) {
-						setWindow(x, y + nLine, x + w - 1, y + nLine + 1, _M5); // y is actual font height, x is font width -1
+						out.row(nLine);
 
 						uint16_t pat = (i < font.data_rows) ? ((p[i * 2] << 8) | p[i * 2 + 1]) : 0;
 						uint16_t last_bit = 0;
@@ -329,9 +299,9 @@ namespace TWEARD {
 								col1 = (bold && last_bit ? color : col2);
 							}
 
-							windowWrite16(col1, _M5);
+							out.put(col1);
 							if (yokobai) {
-								windowWrite16(col2, _M5);
+								out.put(col2);
 							}
 							last_bit = bit;
 						}
@@ -345,9 +315,9 @@ namespace TWEARD {
 							col2 = col1;
 						}
 						for (; j < (font.width + font.w_space) * 2; j++) {
-							windowWrite16(col1, _M5);
+							out.put(col1);
 							if (yokobai) {
-								windowWrite16(col2, _M5);
+								out.put(col2);
 							}
 						}
 						nLine++;
@@ -355,22 +325,255 @@ namespace TWEARD {
 				}
 				// blank line (bottom)
 				for (; i < font.height + font.h_space; i++) {
-					setWindow(x, y + nLine, x + w - 1, y + nLine + 1, _M5); // y is actual font height, x is font width -1
+					out.row(nLine);
 					col1 = cursor ? RED : bg;
 					col2 = col1;
 					for (int j = 0; j < (font.width + font.w_space) * 2; j++) {
-						windowWrite16(col1, _M5);
+						out.put(col1);
 						if (yokobai) {
-							windowWrite16(col2, _M5);
+							out.put(col2);
 						}
 					}
 					nLine++;
 				}
-				endWrite(_M5);
 			}
+		}
+	}
+
+	/// <summary>
+	/// LRU cache of rendered glyphs, keyed by (font, char code, color, bg, opt).
+	///   - a glyph is stored as pixels of the target (RGB565 on ESP32, RGBA on PC),
+	///     up to GLYPH_CACHE_MAXPX pixels (bigger one is rendered without caching).
+	///   - the font key includes the font geometry, as createFontXXX() may re-register the same font_code.
+	/// </summary>
+#if defined(ESP32)
+	#define GLYPH_CACHE_SLOTS 16
+	#define GLYPH_CACHE_MAXPX 384
+	typedef uint16_t GLYPH_PIX;
+#elif defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
+	#define GLYPH_CACHE_SLOTS 512
+	#define GLYPH_CACHE_MAXPX 1280
+	typedef RGBA GLYPH_PIX;
+#endif
+	#define GLYPH_CACHE_HASH (GLYPH_CACHE_SLOTS * 2) // power of 2
+
+	class _GlyphCache {
+	public:
+		struct key {
+			const void* font_data;	// font data set (font_wide or font_latin1, a font_code may be re-registered with other data)
+			uint32_t font_sig;	// font_code, width, height, w_space, h_space and opt (tatebai/yokobai)
+			uint16_t c;			// char code
+			uint16_t color;
+			uint16_t bg;
+			uint8_t opt;
+
+			bool operator == (const key& k) const {
+				return font_data == k.font_data && font_sig == k.font_sig && c == k.c && color == k.color && bg == k.bg && opt == k.opt;
+			}
+
+			uint32_t hash() const {
+				uint32_t h = (font_sig ^ uint32_t(uintptr_t(font_data) >> 4)) * 0x9E3779B1UL;
+				h ^= (uint32_t(c) << 16 | opt) * 0x85EBCA77UL;
+				h ^= (uint32_t(color) << 16 | bg) * 0xC2B2AE3DUL;
+				return h ^ (h >> 15);
+			}
+		};
+
+		struct slot {
+			key k;
+			int16_t w, h;
+			int16_t hnext;			// next slot in the same hash bucket
+			int16_t lprev, lnext;	// LRU list (head is the most recent)
+			GLYPH_PIX px[GLYPH_CACHE_MAXPX];
+		};
+
+	private:
+		slot _slots[GLYPH_CACHE_SLOTS];
+		int16_t _bucket[GLYPH_CACHE_HASH];
+		int16_t _lru_head, _lru_tail;
+		int16_t _used;
+
+		void _lru_unlink(int16_t i) {
+			slot& s = _slots[i];
+			if (s.lprev >= 0) _slots[s.lprev].lnext = s.lnext; else _lru_head = s.lnext;
+			if (s.lnext >= 0) _slots[s.lnext].lprev = s.lprev; else _lru_tail = s.lprev;
+		}
+
+		void _lru_push_head(int16_t i) {
+			slot& s = _slots[i];
+			s.lprev = -1;
+			s.lnext = _lru_head;
+			if (_lru_head >= 0) _slots[_lru_head].lprev = i; else _lru_tail = i;
+			_lru_head = i;
+		}
+
+		void _hash_unlink(int16_t i) {
+			int16_t* pp = &_bucket[_slots[i].k.hash() & (GLYPH_CACHE_HASH - 1)];
+			while (*pp >= 0) {
+				if (*pp == i) { *pp = _slots[i].hnext; break; }
+				pp = &_slots[*pp].hnext;
+			}
+		}
 
-			return font.get_width() * 2;
+	public:
+		_GlyphCache() : _lru_head(-1), _lru_tail(-1), _used(0) {
+			for (auto& b : _bucket) b = -1;
 		}
+
+		static key make_key(const TWEFONT::FontDef& font, uint16_t c, uint16_t color, uint16_t bg, uint8_t opt) {
+			key k;
+			k.font_data = font.font_wide ? (const void*)font.font_wide : (const void*)font.font_latin1;
+			k.font_sig = uint32_t(font.font_code)
+				| (uint32_t(font.width) << 8)
+				| (uint32_t(font.height) << 14)
+				| (uint32_t(font.w_space & 0x0F) << 20)
+				| (uint32_t(font.h_space & 0x0F) << 24)
+				| ((font.opt & (TWEFONT::U32_OPT_FONT_TATEBAI | TWEFONT::U32_OPT_FONT_YOKOBAI)) << 20); // bit 28, 29
+			k.c = c;
+			k.color = color;
+			k.bg = bg;
+			k.opt = opt;
+			return k;
+		}
+
+		// find the glyph and mark it as the most recent, nullptr if not found.
+		slot* find(const key& k) {
+			for (int16_t i = _bucket[k.hash() & (GLYPH_CACHE_HASH - 1)]; i >= 0; i = _slots[i].hnext) {
+				if (_slots[i].k == k) {
+					if (_lru_head != i) {
+						_lru_unlink(i);
+						_lru_push_head(i);
+					}
+					return &_slots[i];
+				}
+			}
+			return nullptr;
+		}
+
+		// get a slot for the new key (evict the least recent one if full).
+		slot& add(const key& k) {
+			int16_t i;
+			if (_used < GLYPH_CACHE_SLOTS) {
+				i = _used++;
+			}
+			else {
+				i = _lru_tail;
+				_lru_unlink(i);
+				_hash_unlink(i);
+			}
+
+			slot& s = _slots[i];
+			s.k = k;
+			s.w = s.h = 0;
+
+			int16_t& b = _bucket[k.hash() & (GLYPH_CACHE_HASH - 1)];
+			s.hnext = b;
+			b = i;
+			_lru_push_head(i);
+
+			return s;
+		}
+	};
+
+	static _GlyphCache& s_glyph_cache() {
+		static _GlyphCache* p = new _GlyphCache(); // on the heap, the slots are big.
+		return *p;
+	}
+
+	/// <summary>
+	/// draw a glyph from the cache.
+	/// </summary>
+	static inline void s_blit_glyph(int32_t x, int32_t y, const _GlyphCache::slot& s, M5Stack& _M5) {
+#if defined(ESP32)
+		startWrite(_M5);
+		for (int i = 0; i < s.h; i++) {
+			setWindow(x, y + i, x + s.w - 1, y + i + 1, _M5);
+			_M5.Lcd.pushColors((uint16_t*)&s.px[s.w * i], s.w); // swapped as tft_Write_16()
+		}
+		endWrite(_M5);
+#elif defined (_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
+		_M5.Lcd.writeRect(x, y, s.w, s.h, s.px);
+#endif
+	}
+
+	/// <summary>
+	/// draw a char in LCD (M5stack)
+	/// 
+	/// Note: setWindow() does not allow bigger area (maybe > 256bytes).
+	///       it should be set row by row when drawing a bigger char.
+	/// 
+	/// Note: rendered glyphs are kept in the cache (s_glyph_cache()), 
+	///       the next drawing with the same font/char/colors/opt is a copy of pixels.
+	/// </summary>
+	/// <param name="x"></param>
+	/// <param name="y"></param>
+	/// <param name="c">drawing character (UNICODE)</param>
+	/// <param name="color"></param>
+	/// <param name="bg"></param>
+	/// <param name="opt">
+	///   MASK 0x01 : render bold style.
+	///   MASK 0x02 : underline.
+	///   MASK 0x80 : cursor.
+	/// </param>
+	/// <returns></returns>
+	int16_t drawChar(const TWEFONT::FontDef& font, int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t opt, M5Stack& _M5) {
+		// check if default font. 
+		if (font.is_default()) {
+			// (maybe this code is unexpected)
+
+#if defined(ESP32)
+			if (TWEUTILS::Unicode_isSingleWidth(c) && c < 0x80) {
+				M5.Lcd.drawChar(x, y, c, color, bg, 1);
+			}
+			else {
+				M5.Lcd.drawChar(x, y, '#', bg, color, 1); // write something
+			}
+
+			return font.get_width();
+#elif defined (_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
+			return 0;
+#endif
+		}
+
+#ifdef DEBUGSER
+		Serial.printf("(%d:%04x)", font.get_font_code(), c);
+#endif
+
+		bool wide = !TWEUTILS::Unicode_isSingleWidth(c);
+
+		// check wide char font data presence.
+		if (wide && font.font_wide == nullptr) return 0; // nurupo check
+
+		int w, h;
+		s_glyph_size(font, wide, w, h);
+
+		if (w * h <= GLYPH_CACHE_MAXPX) {
+			_GlyphCache& cache = s_glyph_cache();
+			_GlyphCache::key k = _GlyphCache::make_key(font, c, uint16_t(color), uint16_t(bg), opt);
+
+			_GlyphCache::slot* s = cache.find(k);
+			if (s == nullptr) {
+				// render into the new slot
+				s = &cache.add(k);
+				s->w = int16_t(w);
+				s->h = int16_t(h);
+
+				_GlyphSinkBuf<GLYPH_PIX> out{ s->px };
+				s_render_glyph(font, c, uint16_t(color), uint16_t(bg), opt, out);
+			}
+
+			s_blit_glyph(x, y, *s, _M5);
+		}
+		else {
+			// too big, render directly
+			_GlyphSinkLcd out{ _M5, x, y, w };
+
+			startWrite(_M5);
+			s_render_glyph(font, c, uint16_t(color), uint16_t(bg), opt, out);
+			endWrite(_M5);
+		}
+
+		return wide ? font.get_width() * 2 : font.get_width();
 	}
 
 
@@ -22,7 +22,20 @@ using namespace TWEARD;
 
 const uint16_t TWEARD::COLTBL_DEFAULT[8] = { BLACK, RED, GREEN, YELLOW, BLUE, MAGENTA, CYAN, ALMOST_WHITE };
 
+// move pixels of the area (x, y0)-(x + w, y1) up by dy, returns false if not supported.
+static bool s_scroll_region(M5Stack& _M5, int32_t x, int32_t y0, int32_t w, int32_t y1, int32_t dy) {
+#if defined(ESP32)
+	// NOTE: the vertical scroll of ILI9341 (VSCRDEF/VSCRSADD) runs along the long side of the panel
+	//       (horizontal in landscape) over its full width, it can't move the console area.
+	return false;
+#else
+	return _M5.Lcd.scroll_region(y0, y1, dy, x, w);
+#endif
+}
+
 // implement refresh function
+//   - the cells of the lines to be updated are compared with the cells rendered last time (_shadow),
+//     only runs of changed cells are rendered.
 void TWEARD::TWETerm_M5_Console::refresh() {
 	// if not visible, don't draw here!
 	if (!visible()) return;
@@ -34,12 +47,20 @@ void TWEARD::TWETerm_M5_Console::refresh() {
 		clear();
 		set_font(screen_mode);
 
-		u32Dirty = U32DIRTY_FULL;
+		dirty_lines.set_full();
 		u8OptRefresh = U8OPT_REFRESH_HARDWARE_CLEAR_MASK;
 	}
 
-	// redraw whole screen
-	if (u32Dirty == U32DIRTY_FULL) {
+	// the rendered screen is not reliable
+	if (u8OptRefresh & (U8OPT_REFRESH_HARDWARE_CLEAR_MASK | U8OPT_REFRESH_REPAINT_MASK)) {
+		_shadow.invalidate();
+		_cursor_l_last = -1;
+	}
+
+	// redraw whole screen, or scrolled
+	if (dirty_lines.is_full() || scroll_lines) {
+		uint16_t fg_save = _fg, bg_save = _bg;
+
 		if (escseq_attr & 0x80) {
 			_bg = COL_TBL[(escseq_attr >> 4) & 0x07];
 		}
@@ -52,12 +73,52 @@ void TWEARD::TWETerm_M5_Console::refresh() {
 		else {
 			_fg = _fg_def;
 		}
+		if (_fg != fg_save || _bg != bg_save) {
+			// default colors are changed, render all.
+			_shadow.invalidate();
+			dirty_lines.set_full();
+		}
+
 		if (u8OptRefresh & U8OPT_REFRESH_HARDWARE_CLEAR_MASK) {
 			// clear screen
 			_M5.Lcd.fillRect(_rect.x, _rect.y, _rect_view.w, _rect_view.h, _bg_def);
 		}
 	}
 
+	// scroll the rendered pixels and _shadow, then only exposed lines are rendered.
+	//   - all cells must be in the view, otherwise the moved pixels would be incomplete.
+	//   - only if it saves work: moving the whole region is counted as 1/SCROLL_MOVE_RATIO cell per cell,
+	//     e.g. the near identical lines are redrawn fewer cells without moving.
+	bool bScrolled = false;
+	if (scroll_lines && !dirty_lines.is_full() && scroll_lines <= max_line) {
+		const int lines = max_line + 1;
+		const int cols = max_col + 1;
+		int16_t x0, y0, x1, y1;
+		get_cursor_pos(x0, y0, 0, 0);
+		get_cursor_pos(x1, y1, max_col + 1, lines);
+
+		bool bMove = x0 >= _rect.x && x1 <= _rect.x + _rect_view.w && y0 >= _rect.y && y1 <= _rect.y + _rect_view.h;
+		if (bMove) {
+			int n_keep = 0, n_move = lines * cols / SCROLL_MOVE_RATIO;
+			for (int i = 0; i < lines && n_move < n_keep + cols * (lines - i); i++) {
+				TWETERM::GChar* cells = _shadow.work_line();
+				get_line_cells(i, cells);
+				n_keep += _shadow.count_diff(i, cells, cols);
+				n_move += (i + scroll_lines < lines) ? _shadow.count_diff(i + scroll_lines, cells, cols) : cols;
+			}
+			bMove = n_move < n_keep;
+		}
+
+		if (bMove && s_scroll_region(_M5, x0, y0, x1 - x0, y1, scroll_lines * font_height())) {
+			_shadow.scroll_up(scroll_lines, lines);
+			if (_cursor_l_last >= 0) {
+				_cursor_l_last -= scroll_lines;
+				if (_cursor_l_last < 0) _cursor_l_last = -1;
+			}
+			bScrolled = true;
+		}
+	}
+
 	// cursor blink
 	uint16_t u16now = millis() & 0xffff;
 	bool bUpdateCursor = false;
@@ -70,73 +131,45 @@ void TWEARD::TWETerm_M5_Console::refresh() {
 		_u16timer_blink = u16now; // timer count update
 	}
 
-	// update the line specified u32Dirty bitmask (bit0 -> line 0, bit1 -> line 1, ...)
-	// save previous cursor pos
-	if (u32Dirty || bUpdateCursor) { // dirty flag or cursor update
-
-		auto font = TWEFONT::queryFont(font_id());
+	// update the lines in dirty_lines, and the lines of the cursor (new and last).
+	//   - if scrolled without moving the pixels, all lines are compared with _shadow.
+	if (dirty_lines || scroll_lines || bUpdateCursor) { // dirty flag or cursor update
+		const TWEFONT::FontDef& font = TWEFONT::queryFont(font_id());
+		const int cols = max_col + 1;
+		const bool bAll = dirty_lines.is_full() || (scroll_lines && !bScrolled);
+		int16_t cursor_l_drawn = -1;
 
-		//Serial.printf("R(%x)", u32Dirty); // DEBUG
 		for (int i = 0; i <= max_line; i++) {
-			if (((1UL << i) & u32Dirty) || (bUpdateCursor && i == cursor_l)) { // update only necessary line
-				int16_t x, y;
-
-				// find the buffer index at line 'i'.
-				int L = calc_line_index(i);
-
-#ifdef DEBUG_SER
-				if (max_line <= 2) {
-					Serial.printf("\nLINE(%02d/%d): ", i, astr_screen[L].length());
-					for (int k = 0; k < astr_screen[L].length(); k++) {
-						uint16_t c = astr_screen[L][k];
-						if (c < 0x80) {
-							Serial.printf("%c", c);
-						}
-						else {
-							Serial.printf("<%04x>", c);
-						}
-					}
-				}
-#endif
+			if (!(bAll || dirty_lines.test(i) || i == cursor_l || i == _cursor_l_last)) continue;
 
-				// length of the line
-				unsigned len = astr_screen[L].length();
-				unsigned j_start = 0;
-				unsigned j_end = len + 1;
+			// the cells to be rendered
+			TWETERM::GChar* cells = _shadow.work_line();
+			get_line_cells(i, cells);
 
-				if (u32Dirty == U32DIRTY_FULL || u8OptRefresh & U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK) {
-					j_end = max_col + 1; // clear whole columns of the target line.
-				}
-				if (u32Dirty == 0 && bUpdateCursor) {
-					// only draw cursor
-					j_start = cursor_c;
-					j_end = cursor_c + 1;
+			if (cursor_mode && i == cursor_l && _u8cursor) {
+				int v = column_idx_to_vis(cursor_c, calc_line_index(i));
+				if (v <= max_col) {
+					cells[v].attr() |= TWETERM::ShadowScreen::ATTR_CURSOR;
+					cursor_l_drawn = i;
 				}
+			}
 
-				// loop for column
-				for (unsigned j = j_start; j < j_end + 1; j++) { // for drawing/erasing cursor, draw one byte more.
-					uint16_t c[2];
-					TWETERM::GChar::tAttr attr;
+			// render runs of changed cells
+			int b = 0, e = 0;
+			while (_shadow.next_run(i, cells, cols, b, e)) {
+				for (int v = b; v < e; v++) {
+					uint16_t c = cells[v].chr();
+					TWETERM::GChar::tAttr attr = cells[v].attr();
 
-					if (j < astr_screen[L].length()) {
-						c[0] = astr_screen[L][j].chr();
-						attr = astr_screen[L][j].attr();
-					}
-					else {
-						c[0] = ' '; // blank
-						attr = escseq_attr_default; // default attribute is applied (effective, if color attribute applied when screen cleared.)
-					}
-					c[1] = 0;
-					// calc the position
-					uint16_t c_vis = column_idx_to_vis(j, L);
-					if ((c_vis + (TWEUTILS::Unicode_isSingleWidth(c[0]) ? 0 : 1)) > max_col) break; // check boundary 
+					if (attr & TWETERM::ShadowScreen::ATTR_WIDE_TAIL) continue; // rendered with the head.
 
-					get_cursor_pos(x, y, uint8_t(c_vis), uint8_t(i));
+					int16_t x, y;
+					get_cursor_pos(x, y, int16_t(v), int16_t(i));
 
 					// if actual position excess the boundary.
-					if (x < _rect.x || x + (TWEUTILS::Unicode_isSingleWidth(c[0]) ? 1 : 2) * font.get_width() > _rect.x + _rect_view.w) continue;
+					if (x < _rect.x || x + (TWEUTILS::Unicode_isSingleWidth(c) ? 1 : 2) * font.get_width() > _rect.x + _rect_view.w) continue;
 					if (y < _rect.y || y + font.get_height() > _rect.y + _rect_view.h) continue;
-					
+
 					// calc the color
 					uint16_t fg = _fg; // default fg
 					uint16_t bg = _bg; // default bg
@@ -155,36 +188,22 @@ void TWEARD::TWETerm_M5_Console::refresh() {
 						bg = t;
 					}
 
-					bool bCursor = false;
-					if (cursor_mode && i == cursor_l && j == cursor_c && _u8cursor) {
-						bCursor = true;
-						// draw cursor
-						//fg = BLACK;
-						//bg = RED;
-#ifdef DEBUG_SER
-						if (max_line > 10) {
-							Serial.printf("."); // DEBUG
-							Serial.printf("(%d,%d,%2X:%04x)", i, j, attr, c[0]); // DEBUG
-						}
-#endif
-					}
-					else if (i == _cursor_l_last && j == _cursor_c_last) {		
-						// redraw with attr of last cursor position.
-						// render as normal
-
-						//Serial.printf("(%d,%d,%2X:%c)", i, j, attr, c[0]); // DEBUG
+					bool bCursor = (attr & TWETERM::ShadowScreen::ATTR_CURSOR);
 
-						// NOTE: everytime, j_end is set properly to reach here, otherwise, the previous cursor remains...
+#ifdef DEBUG_SER
+					if (bCursor && max_line > 10) {
+						Serial.printf("(%d,%d,%2X:%04x)", i, v, attr, c); // DEBUG
 					}
+#endif
 
 					if (font.is_default()) {
 						// render with default font
 #if defined (ESP32)
-						if (c[0] < 0x100) _M5.Lcd.drawChar(x, y, c[0], fg, bg, 1);
+						if (c < 0x100) _M5.Lcd.drawChar(x, y, c, fg, bg, 1);
 #endif
 					}
 					else {
-						drawChar(font, x, y, c[0], 
+						drawChar(font, x, y, c, 
 						      fg
 							, bg 
 							, ((attr & TWETERM::E_ESCSEQ_BOLD_MASK) ? 1 : 0) 
@@ -192,13 +211,15 @@ void TWEARD::TWETerm_M5_Console::refresh() {
 								| (bCursor ? 0x80 : 0)
 							, _M5
 						);
-					}					
+					}
 				}
+
+				_shadow.commit(i, cells, b, e);
+				b = e;
 			}
 		}
 
-		_cursor_l_last = uint8_t(cursor_l);
-		_cursor_c_last = uint8_t(cursor_c);
+		_cursor_l_last = cursor_l_drawn;
 	}
 
 	post_refresh(); // clear flags, etc.
@@ -209,6 +230,7 @@ void TWEARD::TWETerm_M5_Console::set_font(uint8_t font_id, uint8_t u8col_request
 	_font_height = font.get_height();
 	_font_width = font.get_width();
 	_font_id = font_id;
+	_shadow.invalidate();
 
 	if (_font_width == 0 || _font_height == 0) {
 		_font_height = 8;
@@ -37,8 +37,7 @@ namespace TWEARD {
 		// cursor control
 		uint8_t _u8cursor = 0;
 		uint16_t _u16timer_blink;
-		uint8_t _cursor_l_last = 0;
-		uint8_t _cursor_c_last = 0;
+		int16_t _cursor_l_last = -1; // the line where the cursor is rendered (-1: none)
 
 		// color control
 		uint16_t _fg, _bg, _fg_def, _bg_def;
@@ -49,6 +48,12 @@ namespace TWEARD {
 		// the color table
 		const uint16_t* COL_TBL;
 
+		// the cells rendered last time (only changed cells are rendered).
+		TWETERM::ShadowScreen _shadow;
+
+		// moving the pixels of a cell is counted as 1/SCROLL_MOVE_RATIO of rendering a cell.
+		static const int SCROLL_MOVE_RATIO = 4;
+
 	public:
 		inline uint8_t font_width() { return _font_width; }
 		inline uint8_t font_height() { return _font_height; }
@@ -73,7 +78,7 @@ namespace TWEARD {
 			uint8_t u8c, uint8_t u8l,
 			TWETERM::SimpBuf_GChar* pAryLines, TWETERM::GChar* pBuff,
 			Rect drawArea, M5Stack& M5OBJ)
-			: ITerm(u8c, u8l, pAryLines, pBuff), _rect(drawArea), _M5(M5OBJ)
+			: ITerm(u8c, u8l, pAryLines, pBuff), _rect(drawArea), _M5(M5OBJ), _shadow(u8c, u8l)
 		{
 			_init();
 		}
@@ -82,7 +87,7 @@ namespace TWEARD {
 		TWETerm_M5_Console(
 			uint8_t u8c, uint8_t u8l,
 			Rect drawArea, M5Stack& M5OBJ)
-			: ITerm(u8c, u8l), _rect(drawArea), _M5(M5OBJ)
+			: ITerm(u8c, u8l), _rect(drawArea), _M5(M5OBJ), _shadow(u8c, u8l)
 		{
 			_init();
 		}
@@ -113,25 +118,29 @@ namespace TWEARD {
 
 		// set position of virtual area.
 		void set_view_pos(int16_t x, int16_t y) {
+			if (_rect_view.x != x || _rect_view.y != y) _shadow.invalidate();
 			_rect_view.x = x;
 			_rect_view.y = y;
 		}
 
 		// set actual rendering size.
 		void set_view_size(int16_t w, int16_t h) {
+			_shadow.invalidate();
 			_rect_view.w = w;
 			_rect_view.h = h;
 		}
 
 		// set drawing area (should be set font again)
 		void set_draw_area(Rect drawArea) {
+			_shadow.invalidate();
 			_rect = drawArea;
 		}
 
 		void set_font(uint8_t u8id, uint8_t u8col_request = 0, uint8_t u8row_request = 0); // change font and resize screen
-		void set_color(uint16_t color, uint16_t bgcolor = 0) { _bg = _bg_def = bgcolor; _fg = _fg_def = color; }
+		void set_color(uint16_t color, uint16_t bgcolor = 0) { _bg = _bg_def = bgcolor; _fg = _fg_def = color; _shadow.invalidate(); }
 		void set_color_table(const uint16_t* ptbl) {
 			COL_TBL = ptbl;
+			_shadow.invalidate();
 		}
 
 		void refresh(); // redraw function
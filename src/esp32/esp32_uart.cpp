@@ -40,6 +40,10 @@ void SerialESP32::begin(uint32_t baud, uint16_t buff_rx, uint16_t buff_tx) {
 		//uart_driver_install(_uart_num, uart_buffer_size, uart_buffer_size, 0, nullptr, 0);
 		//uart_set_mode(_uart_num, UART_MODE_UART);
 
+		// RX task (drains the driver buffer into _que, core 0 where loop() doesn't run)
+		_que.setup(TWEUTILS::SpscQueue<uint8_t>::size_type(buff_rx) * 2);
+		xTaskCreatePinnedToCore(_rx_task_main, "twe_uart_rx", 2048, this, configMAX_PRIORITIES - 2, &_rx_task, 0);
+
 		// recreate new instance
 		WrtTWE.reset(new TWE_PutChar_Serial<SerialESP32>(*this)); // switch object
 		_gen_modctrl_for_esp32_uart();
@@ -51,4 +55,43 @@ void SerialESP32::begin(uint32_t baud, uint16_t buff_rx, uint16_t buff_tx) {
 		uart_set_baudrate(_uart_num, baud);
 	}
 }
-#endif
\ No newline at end of file
+// the RX task, the producer of _que.
+void SerialESP32::_rx_task_main(void* pv) {
+	SerialESP32& ser = *(SerialESP32*)pv;
+	uint8_t buf[256];
+	uart_event_t ev;
+
+	while (true) {
+		if (xQueueReceive(ser._uart_queue, &ev, portMAX_DELAY) != pdTRUE) continue;
+
+		switch (ev.type) {
+		case UART_DATA:
+			// read all bytes in the driver buffer (possibly more than ev.size)
+			while (true) {
+				size_t n_avail = 0;
+				uart_get_buffered_data_len(ser._uart_num, &n_avail);
+				if (n_avail == 0) break;
+
+				int n = uart_read_bytes(ser._uart_num, buf, n_avail < sizeof(buf) ? n_avail : sizeof(buf), 0);
+				if (n <= 0) break;
+
+				if (ser._que.push(buf, TWEUTILS::SpscQueue<uint8_t>::size_type(n)) < TWEUTILS::SpscQueue<uint8_t>::size_type(n)) {
+					ser._n_overrun++; // loop() is too slow, the rest is lost.
+				}
+			}
+			break;
+
+		case UART_FIFO_OVF:
+		case UART_BUFFER_FULL:
+			// the data is broken anyway, restart from the clean state.
+			ser._n_overrun++;
+			uart_flush_input(ser._uart_num);
+			xQueueReset(ser._uart_queue);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+#endif
@@ -6,21 +6,40 @@
 #ifdef ESP32
 #include "twe_common.hpp"
 #include "twe_serial.hpp"
+#include "twe_utils_spscque.hpp"
 
 #include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <freertos/queue.h>
 
 namespace TWE {
+	/**
+	 * @class	SerialESP32
+	 *
+	 * @brief	UART2 via ESP-IDF driver.
+	 * 			The RX task waits for UART_DATA events of the driver's event queue and drains
+	 * 			the driver buffer into _que in chunks, read() side only touches _que.
+	 */
 	class SerialESP32 : public ISerial {
 		const uart_port_t _uart_num;
 		bool _opened;
 		QueueHandle_t _uart_queue;
 
+		TaskHandle_t _rx_task;
+		TWEUTILS::SpscQueue<uint8_t> _que; // RX task -> read()
+		volatile uint32_t _n_overrun; // count of overrun events (FIFO/driver buffer/_que)
+
+		static void _rx_task_main(void* pv);
+
 	public:
 		SerialESP32() 
-			: _opened(false)
-			, _uart_num(UART_NUM_2)
-			, _uart_queue(nullptr) {}
+			: _uart_num(UART_NUM_2)
+			, _opened(false)
+			, _uart_queue(nullptr)
+			, _rx_task(nullptr)
+			, _que()
+			, _n_overrun(0) {}
 		~SerialESP32() {}
 
 		/**
@@ -35,17 +54,35 @@ namespace TWE {
 		void begin(uint32_t baud, uint16_t buff_rx = 1024, uint16_t buff_tx = 1024);
 		
 		inline int read() {
-			uint8_t buf[1];
-			int n = uart_read_bytes(_uart_num, buf, 1, 0);
-			return n == 1 ? buf[0] : -1;
+			if (!_que.empty()) {
+				uint8_t c = _que.front();
+				_que.pop();
+				return c;
+			}
+			return -1;
+		}
+
+		/**
+		 * @fn	inline int SerialESP32::read(uint8_t* dst, size_t max)
+		 *
+		 * @brief	Reads received bytes at once.
+		 *
+		 * @param [out]	dst	The destination buffer.
+		 * @param 	   	max	The size of the buffer.
+		 *
+		 * @returns	count of read bytes, 0: no data.
+		 */
+		inline int read(uint8_t* dst, size_t max) {
+			return (int)_que.pop_front(dst, TWEUTILS::SpscQueue<uint8_t>::size_type(max));
 		}
 
 		inline int available() {
-			size_t n_avail;
-			uart_get_buffered_data_len(_uart_num, &n_avail);
-			return (int)n_avail;
+			return (int)_que.size();
 		}
 
+		// count of overrun events since begin().
+		inline uint32_t get_overrun_count() { return _n_overrun; }
+
 		int write(const uint8_t* p, int len) { return uart_write_bytes(_uart_num, (const char*)p, len); }
 		int write(const char* p, int len) { return write((uint8_t*)p, len); }
 		void flush() { uart_wait_tx_done(_uart_num, 100); }
@@ -12,6 +12,7 @@
 
 #elif defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
 #include <vector>
+#include <memory>
 
 #include "twe_common.hpp"
 #include "twe_font.hpp"
@@ -21,25 +22,82 @@
 extern bool g_quit_sdl_loop;
 			
 namespace TWEARD {
+#if defined(MWM5_HEADLESS)
+	// null sink for the headless build (no frame buffer, nothing is rendered).
+	class LcdScreen {
+		RGBA _pt_dummy; // written by ref_pt(), never read.
+
+	public:
+		LcdScreen(int w, int h) : _pt_dummy{} {}
+
+		inline RGBA get_pt(int32_t x, int32_t y) { return RGBA{}; }
+		inline RGBA& ref_pt(int32_t x, int32_t y) { return _pt_dummy; }
+
+		void setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {}
+		void writeWindows565(uint16_t c) {}
+		void fillRect(const int32_t x, const int32_t y, const int32_t w, const int32_t h, const uint32_t c) {}
+		void writeRect(const int32_t x, const int32_t y, const int32_t w, const int32_t h, const RGBA* px) {}
+		bool scroll_region(int32_t y0, int32_t y1, int32_t dy, int32_t x = 0, int32_t w = -1) { return true; }
+
+		// do nothing
+		void startWrite() {}
+		void endWrite() {}
+
+		// update
+		bool update_line(int32_t y) { return false; }
+		bool update_line(int32_t y, int32_t& x0, int32_t& x1) { return false; }
+		bool get_damage(Rect& r) const { return false; }
+		void clear_damage() {}
+		void update_line_all() {}
+		inline bool is_dirty() const { return false; }
+	};
+#else
 	class LcdScreen {
 		int32_t _w; // screen width
 		int32_t _h; // screen height
 
 		RGBA* _fb; // screen buffer
-		std::vector<bool> _y_upd; // lines flags, ture to be rendered.
+
+		// damage tracking
+		//   - the dirty column span [_x0[y], _x1[y]] of each line (clean if _x0[y] > _x1[y]).
+		//   - the bounding box of all dirty spans (_dmg_x0.._dmg_x1, _dmg_y0.._dmg_y1, empty if _dmg_y0 > _dmg_y1).
+		std::unique_ptr<int16_t[]> _x0;
+		std::unique_ptr<int16_t[]> _x1;
+		int32_t _dmg_x0, _dmg_y0, _dmg_x1, _dmg_y1;
 
 		Rect _window; // set rendering window (simulate LCD op)
 		int32_t _window_x, _window_y; // render pix position for writeWindows565(), where the rendering window set by setWindow()
 
+		// mark [x0, x1] of the line y as dirty (x0, x1 and y must be in the screen).
+		inline void _damage(int32_t x0, int32_t x1, int32_t y) {
+			if (x0 < _x0[y]) _x0[y] = int16_t(x0);
+			if (x1 > _x1[y]) _x1[y] = int16_t(x1);
+
+			if (x0 < _dmg_x0) _dmg_x0 = x0;
+			if (x1 > _dmg_x1) _dmg_x1 = x1;
+			if (y < _dmg_y0) _dmg_y0 = y;
+			if (y > _dmg_y1) _dmg_y1 = y;
+		}
+
+		inline void _clean_line(int32_t y) {
+			_x0[y] = int16_t(_w);
+			_x1[y] = -1;
+		}
+
 	public:
 		LcdScreen(int w, int h) :
 			_w(w),
 			_h(h),
 			_fb(new RGBA[_w * _h]),
-			_y_upd(_h, false),
+			_x0(new int16_t[_h]),
+			_x1(new int16_t[_h]),
+			_dmg_x0(_w), _dmg_y0(_h), _dmg_x1(-1), _dmg_y1(-1),
 			_window{},
 			_window_x(0),
-			_window_y(0) { }
+			_window_y(0)
+		{
+			for (int32_t y = 0; y < _h; y++) _clean_line(y);
+		}
 
 		~LcdScreen() {
 			delete[] _fb;
@@ -49,8 +107,13 @@ namespace TWEARD {
 			return _fb[_w * y + x];
 		}
 
+		// the head of the line y in the frame buffer (read only).
+		inline const RGBA* get_line(int32_t y) const {
+			return &_fb[_w * y];
+		}
+
 		inline RGBA& ref_pt(int32_t x, int32_t y) {
-			if (y >= 0 && y < _h) _y_upd[y] = true; 
+			if (y >= 0 && y < _h && x >= 0 && x < _w) _damage(x, x, y);
 			return _fb[_w * y + x];
 		}
 
@@ -66,8 +129,6 @@ namespace TWEARD {
 
 		void writeWindows565(uint16_t c) {
 			if (_window_x < _w && _window_y < _h) {
-				_y_upd[_window_y] = true;
-
 				auto&& p = ref_pt(_window_x, _window_y);
 				p = color565toRGBA(c);
 			}
@@ -82,34 +143,143 @@ namespace TWEARD {
 		void fillRect(const int32_t x, const int32_t y, const int32_t w, const int32_t h, const uint32_t c) {
 			RGBA c32 = color565toRGBA(c);
 
-			int32_t wx = x, wy = y;
-			
-			for (; wy < y + h; wy++) {
-				if (wy >= 0 && wy < _h) _y_upd[wy] = true;
+			// clip
+			int32_t x0 = x < 0 ? 0 : x;
+			int32_t x1 = x + w > _w ? _w : x + w;
+			int32_t y0 = y < 0 ? 0 : y;
+			int32_t y1 = y + h > _h ? _h : y + h;
+			if (x0 >= x1 || y0 >= y1) return;
 
-				for (wx = x; wx < x + w; wx++) {
-					auto&& p = ref_pt(wx, wy);
-					p = c32;
+			for (int32_t wy = y0; wy < y1; wy++) {
+				_damage(x0, x1 - 1, wy);
+
+				RGBA* p = &_fb[_w * wy + x0];
+				for (int32_t wx = x0; wx < x1; wx++) *p++ = c32;
+			}
+		}
+
+		// copy a w x h block of pixels (row-major) to (x, y), clipped by the screen.
+		void writeRect(const int32_t x, const int32_t y, const int32_t w, const int32_t h, const RGBA* px) {
+			int32_t x0 = x < 0 ? 0 : x;
+			int32_t x1 = x + w > _w ? _w : x + w;
+			int32_t y0 = y < 0 ? 0 : y;
+			int32_t y1 = y + h > _h ? _h : y + h;
+			if (x0 >= x1 || y0 >= y1) return;
+
+			for (int32_t wy = y0; wy < y1; wy++) {
+				_damage(x0, x1 - 1, wy);
+				memcpy(&_fb[_w * wy + x0], &px[w * (wy - y) + (x0 - x)], (x1 - x0) * sizeof(RGBA));
+			}
+		}
+
+		/**
+		 * @fn	bool LcdScreen::scroll_region(int32_t y0, int32_t y1, int32_t dy, int32_t x = 0, int32_t w = -1)
+		 *
+		 * @brief	Moves pixels of the lines [y0, y1) up by dy (down if dy < 0).
+		 * 			The exposed lines keep the old pixels (to be rendered by the caller).
+		 *
+		 * @param	y0	the top line of the region.
+		 * @param	y1	the line next to the bottom of the region.
+		 * @param	dy	count of lines to move.
+		 * @param	x 	the left column of the region.
+		 * @param	w 	width of the region (-1: to the right end).
+		 *
+		 * @returns	True if the pixels are moved.
+		 */
+		bool scroll_region(int32_t y0, int32_t y1, int32_t dy, int32_t x = 0, int32_t w = -1) {
+			int32_t x0 = x < 0 ? 0 : x;
+			int32_t x1 = (w < 0 || x + w > _w) ? _w : x + w;
+			if (y0 < 0) y0 = 0;
+			if (y1 > _h) y1 = _h;
+			if (x0 >= x1 || y0 >= y1) return false;
+
+			int32_t n = y1 - y0 - (dy < 0 ? -dy : dy); // lines to move
+			if (n > 0 && dy != 0) {
+				int32_t src = dy > 0 ? y0 + dy : y0;
+				int32_t dst = dy > 0 ? y0 : y0 - dy;
+
+				if (x0 == 0 && x1 == _w) {
+					memmove(&_fb[_w * dst], &_fb[_w * src], _w * n * sizeof(RGBA));
+				}
+				else if (dy > 0) {
+					for (int32_t i = 0; i < n; i++)
+						memcpy(&_fb[_w * (dst + i) + x0], &_fb[_w * (src + i) + x0], (x1 - x0) * sizeof(RGBA));
+				}
+				else {
+					for (int32_t i = n - 1; i >= 0; i--)
+						memcpy(&_fb[_w * (dst + i) + x0], &_fb[_w * (src + i) + x0], (x1 - x0) * sizeof(RGBA));
 				}
 			}
+
+			for (int32_t wy = y0; wy < y1; wy++) _damage(x0, x1 - 1, wy);
+			return true;
 		}
 
 		// do nothing
 		void startWrite() {}
 		void endWrite() {}
 
-		// update
+		// update (the damage is cleared when the last line is checked)
 		bool update_line(int32_t y) {
-			bool bupd = _y_upd[y];
-			_y_upd[y] = false;
+			int32_t x0, x1;
+			bool bupd = update_line(y, x0, x1);
+			if (y == _h - 1) clear_damage();
 			return bupd;
 		}
 
+		/**
+		 * @fn	bool LcdScreen::update_line(int32_t y, int32_t& x0, int32_t& x1)
+		 *
+		 * @brief	Gets the dirty column span of the line y and marks it as clean.
+		 *
+		 * @param 		  	y 	the line.
+		 * @param [out]		x0	the first dirty column.
+		 * @param [out]		x1	the last dirty column.
+		 *
+		 * @returns	True if the line has dirty columns.
+		 */
+		bool update_line(int32_t y, int32_t& x0, int32_t& x1) {
+			x0 = _x0[y];
+			x1 = _x1[y];
+			_clean_line(y);
+			return x0 <= x1;
+		}
+
+		/**
+		 * @fn	bool LcdScreen::get_damage(Rect& r)
+		 *
+		 * @brief	Gets the bounding box of damaged area.
+		 *
+		 * @param [out]	r	the bounding box.
+		 *
+		 * @returns	True if some area is damaged.
+		 */
+		bool get_damage(Rect& r) const {
+			if (_dmg_y0 > _dmg_y1) return false;
+
+			r.x = int16_t(_dmg_x0);
+			r.y = int16_t(_dmg_y0);
+			r.w = int16_t(_dmg_x1 - _dmg_x0 + 1);
+			r.h = int16_t(_dmg_y1 - _dmg_y0 + 1);
+			return true;
+		}
+
+		// mark all as clean.
+		void clear_damage() {
+			for (int32_t y = _dmg_y0; y <= _dmg_y1; y++) _clean_line(y);
+			_dmg_x0 = _w; _dmg_y0 = _h; _dmg_x1 = -1; _dmg_y1 = -1;
+		}
+
 		void update_line_all() {
-			_y_upd.assign(_y_upd.size(), true);
+			for (int32_t y = 0; y < _h; y++) _damage(0, _w - 1, y);
 		}
 
+		// true if some lines are to be rendered.
+		inline bool is_dirty() const {
+			return _dmg_y0 <= _dmg_y1;
+		}
 	};
+#endif
 
 	class M5Stack {
 	public:
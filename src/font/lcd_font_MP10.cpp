@@ -16,6 +16,7 @@ namespace TWEFONT {
 	extern const uint8_t font_mplus_f10r_jisx201[64 * FONT_MP10_DATA_ROWS];
 	extern const uint8_t font_mplus_f10r_latin1ex[96 * FONT_MP10_DATA_ROWS];
 	extern const uint16_t font_mplus_f10j_idx[FONT_MP10_DBL_CHARS];
+	extern const FontWidePageTable font_mplus_f10j_idx_pgtbl;
 	extern const uint8_t font_mplus_f10j_data[FONT_MP10_DBL_CHARS * FONT_MP10_DATA_ROWS * 2];
 	extern const uint8_t font_mplus_f10j_unsupported[FONT_MP10_DATA_ROWS * 2];
 
@@ -50,6 +51,7 @@ namespace TWEFONT {
 			font->font_wide_missing = font_mplus_f10j_unsupported;
 			font->font_wide_idx = font_mplus_f10j_idx;	// UNICODE index 
 			font->font_wide_count = FONT_MP10_DBL_CHARS;
+			font->font_wide_pgtbl = &font_mplus_f10j_idx_pgtbl;	// page table of the index
 
 			font->opt = opt;
 			return *font;
@@ -63,4 +65,5 @@ namespace TWEFONT {
 
 // include the font table here (TODO: separate .cpp file would have _unreferenced link error)
 #include "lcd_font_MP10_table.src"
+#include "lcd_font_MP10_pgtbl.src"
 
@@ -17,6 +17,7 @@ namespace TWEFONT {
 	extern const uint8_t font_mplus_f12r_jisx201[64 * FONT_MP12_DATA_ROWS];
 	extern const uint8_t font_mplus_f12r_latin1ex[96 * FONT_MP12_DATA_ROWS];
 	extern const uint16_t font_mplus_f12j_idx[FONT_MP12_DBL_CHARS];
+	extern const FontWidePageTable font_mplus_f12j_idx_pgtbl;
 	extern const uint8_t font_mplus_f12j_data[FONT_MP12_DBL_CHARS * FONT_MP12_DATA_ROWS *2];
 	extern const uint8_t font_mplus_f12j_unsupported[FONT_MP12_DATA_ROWS * 2];
 
@@ -51,6 +52,7 @@ namespace TWEFONT {
 			font->font_wide_missing = font_mplus_f12j_unsupported;
 			font->font_wide_idx = font_mplus_f12j_idx;	// UNICODE index 
 			font->font_wide_count = FONT_MP12_DBL_CHARS;
+			font->font_wide_pgtbl = &font_mplus_f12j_idx_pgtbl;	// page table of the index
 
 			font->opt = opt;
 			return *font;
@@ -63,3 +65,4 @@ namespace TWEFONT {
 
 // include the font table here (TODO: separate .cpp file would have _unreferenced link error)
 #include "lcd_font_MP12_table.src"
+#include "lcd_font_MP12_pgtbl.src"
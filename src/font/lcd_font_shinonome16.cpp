@@ -19,10 +19,12 @@ namespace TWEFONT {
 	extern const uint8_t font_shinonome_f16r_jisx201[64 * FONT_SHINO16_DATA_ROWS];
 	extern const uint8_t font_shinonome_f16r_latin1ex[96 * FONT_SHINO16_DATA_ROWS];
 	extern const uint16_t font_shinonome_f16j_idx[FONT_SHINO16_DBL_CHARS];
+	extern const FontWidePageTable font_shinonome_f16j_idx_pgtbl;
 	extern const uint8_t font_shinonome_f16j_data[FONT_SHINO16_DBL_CHARS * FONT_SHINO16_DATA_ROWS * 2];
 	extern const uint8_t font_shinonome_f16j_unsupported[FONT_SHINO16_DATA_ROWS * 2];
 
 	extern const uint16_t font_shinonome_f16j_idx_full[FONT_SHINO16_DBL_CHARS_FULL];
+	extern const FontWidePageTable font_shinonome_f16j_idx_full_pgtbl;
 	extern const uint8_t font_shinonome_f16j_data_full[FONT_SHINO16_DBL_CHARS_FULL * FONT_SHINO16_DATA_ROWS * 2];
 
 	/// <summary>
@@ -56,6 +58,7 @@ namespace TWEFONT {
 			font->font_wide_missing = font_shinonome_f16j_unsupported;
 			font->font_wide_idx = font_shinonome_f16j_idx;	// UNICODE index 
 			font->font_wide_count = FONT_SHINO16_DBL_CHARS;
+			font->font_wide_pgtbl = &font_shinonome_f16j_idx_pgtbl;	// page table of the index
 
 			font->opt = opt;
 
@@ -97,6 +100,7 @@ namespace TWEFONT {
 			font->font_wide_missing = font_shinonome_f16j_unsupported;
 			font->font_wide_idx = font_shinonome_f16j_idx_full;	// UNICODE index 
 			font->font_wide_count = FONT_SHINO16_DBL_CHARS_FULL;
+			font->font_wide_pgtbl = &font_shinonome_f16j_idx_full_pgtbl;	// page table of the index
 
 			font->opt = opt;
 			return *font;
@@ -109,3 +113,4 @@ namespace TWEFONT {
 
 // include the font table here (TODO: separate .cpp file would have _unreferenced link error)
 #include "lcd_font_shinonome16_table.src"
+#include "lcd_font_shinonome16_pgtbl.src"
@@ -0,0 +1,213 @@
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+#if defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
+
+#include "batch_prog.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+using namespace TWE;
+
+BatchProg::_worker::_worker(const char* name)
+	: devname{}
+	, ser()
+	, modc(ser)
+	, prog(new TweBlProtocol<SerialFtdi, TweModCtlFTDI>(ser, modc))
+	, th()
+	, state(E_STATE::WAIT)
+	, progress(0)
+	, step(TweProg::E_ST_TWEBLP::NONE)
+	, n_pass(1)
+	, i_pass(0)
+	, step_pass(TweProg::E_ST_TWEBLP::NONE)
+	, serial_number(0)
+	, t_elapsed(0)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	strncpy_s(devname, name, sizeof(devname) - 1);
+#else
+	strncpy(devname, name, sizeof(devname) - 1);
+#endif
+}
+
+// called from TweProg in the worker thread.
+void BatchProg::_worker::cb_protocol(TweProg::E_ST_TWEBLP cmd, int req_or_resp, TWE::APIRET evarg, TWEUTILS::SmplBuf_Byte& payl, void* pobj) {
+	_worker& w = *(_worker*)pobj;
+
+	w.step.store(cmd);
+	if ((cmd == TweProg::E_ST_TWEBLP::WRITE_FLASH_FROM_FILE
+			|| cmd == TweProg::E_ST_TWEBLP::VERIFY_FLASH
+			|| cmd == TweProg::E_ST_TWEBLP::COMPARE_FLASH)
+		&& req_or_resp == TweProg::EVENT_RESPOND
+	) {
+		// the passes share the progress equally.
+		if (cmd != w.step_pass) {
+			if (w.step_pass != TweProg::E_ST_TWEBLP::NONE && w.i_pass + 1 < w.n_pass) w.i_pass++;
+			w.step_pass = cmd;
+		}
+		w.progress.store((w.i_pass * 1024 + int(evarg.get_value())) / w.n_pass);
+	}
+}
+
+int BatchProg::begin(const char* file, int max_devices, bool b_diff) {
+	if (is_running()) return 0;
+	join();
+	_workers.clear();
+
+	_file.resize(0);
+	_file << file; // UTF-8 -> wchar_t
+	_b_diff = b_diff;
+
+	// the adapters
+	SerialFtdi::list_devices();
+	if (max_devices > MAX_DEVICES) max_devices = MAX_DEVICES;
+	for (int i = 0; i < SerialFtdi::ser_count && int(_workers.size()) < max_devices; i++) {
+		_workers.emplace_back(new _worker(SerialFtdi::ser_devname[i]));
+	}
+
+	// start workers
+	_n_running.store(int(_workers.size()));
+	for (auto& w : _workers) {
+		_worker* pw = w.get();
+		pw->state.store(E_STATE::RUNNING);
+		pw->th = std::thread([this, pw]() { _run(*pw); });
+	}
+
+	return int(_workers.size());
+}
+
+/**
+ * @fn	void BatchProg::_run(_worker& w)
+ *
+ * @brief	The worker thread, reads the module info and writes the firmware.
+ *
+ * @param [in,out]	w	The worker.
+ */
+void BatchProg::_run(_worker& w) {
+	uint32_t t_start = millis();
+	E_STATE result = E_STATE::ERROR_OPEN;
+
+	auto file = std::make_shared<TweFile>();
+	if (w.ser.open(w.devname) && file->open(_file) && w.prog.set_firmware_data(file)) {
+		w.ser.set_reader_thread(true);
+		w.prog.add_cb(_worker::cb_protocol, &w);
+		w.prog.set_write_window(_n_window);
+		w.n_pass = 1 + (_b_diff ? 1 : 0) + (_b_verify ? 1 : 0);
+		w.i_pass = 0;
+		w.step_pass = TweProg::E_ST_TWEBLP::NONE;
+
+		// reads the serial number first, then erase and write (and verify).
+		const TweProg::E_ST_TWEBLP* tbls[] = { TweProg::BL_PROTOCOL_GET_MODULE_INFO
+			, TweProg::write_protocol(_b_diff, _b_verify) };
+
+		result = E_STATE::SUCCESS;
+		for (auto tbl : tbls) {
+			w.prog.rewind_firmware_data();
+			w.prog.clear_state();
+
+			bool b_exit = !w.prog.begin(tbl);
+			while (!b_exit) {
+				int c = w.ser.read();
+				if (c < 0) {
+					delay(1); // wait for the reader thread
+				}
+				b_exit = w.prog.process_input(c); // -1: time out check
+			}
+
+			if (w.prog.get_state() != TweProg::E_ST_TWEBLP::FINISH) {
+				result = E_STATE::ERROR_PROG;
+				break;
+			}
+
+			if (tbl == TweProg::BL_PROTOCOL_GET_MODULE_INFO) {
+				w.serial_number = w.prog.module_info.serial_number;
+			}
+		}
+
+		w.prog.reset_module();
+	}
+
+	w.ser.close();
+	file->close();
+
+	w.t_elapsed = millis() - t_start;
+	if (result == E_STATE::SUCCESS) w.progress.store(1024);
+	w.state.store(result);
+	_n_running--;
+}
+
+void BatchProg::join(const char* log_path) {
+	bool b_joined = false;
+	for (auto& w : _workers) {
+		if (w->th.joinable()) {
+			w->th.join();
+			b_joined = true;
+		}
+	}
+
+	if (b_joined && log_path) _write_log(log_path);
+}
+
+// appends CSV lines: time, adapter, module serial, result, last step, elapsed ms, write window.
+void BatchProg::_write_log(const char* path) {
+	FILE* fp = nullptr;
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	if (fopen_s(&fp, path, "a") != 0) fp = nullptr;
+#else
+	fp = fopen(path, "a");
+#endif
+	if (fp == nullptr) return;
+
+	time_t t = time(nullptr);
+	struct tm tm_now;
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	localtime_s(&tm_now, &t);
+#else
+	localtime_r(&t, &tm_now);
+#endif
+	char tstr[32];
+	strftime(tstr, sizeof(tstr), "%Y-%m-%d %H:%M:%S", &tm_now);
+
+	for (auto& w : _workers) {
+		fprintf(fp, "%s,%s,%08X,%s,%d,%u,%d\n"
+			, tstr
+			, w->devname
+			, w->serial_number
+			, state_name(w->state.load())
+			, int(w->step.load())
+			, w->t_elapsed
+			, int(_n_window));
+	}
+
+	fclose(fp);
+}
+
+int BatchProg::get_progress_total() const {
+	if (_workers.empty()) return 0;
+
+	int sum = 0;
+	for (auto& w : _workers) sum += w->progress.load();
+	return sum / int(_workers.size());
+}
+
+int BatchProg::count_state(E_STATE s) const {
+	int ct = 0;
+	for (auto& w : _workers) if (w->state.load() == s) ct++;
+	return ct;
+}
+
+const char* BatchProg::state_name(E_STATE s) {
+	switch (s) {
+	case E_STATE::WAIT: return "WAIT";
+	case E_STATE::RUNNING: return "RUNNING";
+	case E_STATE::SUCCESS: return "OK";
+	case E_STATE::ERROR_OPEN: return "NG(OPEN)";
+	case E_STATE::ERROR_PROG: return "NG(PROG)";
+	default: return "?";
+	}
+}
+
+#endif //WIN/MAC/LINUX
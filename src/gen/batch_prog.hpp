@@ -0,0 +1,133 @@
+#pragma once
+
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+/*
+ * Batch programming: writes the same firmware into modules on all attached
+ * adapters (MONOSTICK/TWE-Lite-R) at once, one worker thread per adapter.
+ * Each worker owns its SerialFtdi, TweModCtlFTDI, TweBlProtocol, TweProg and TweFile,
+ * nothing is shared with the global Serial2/twe_prog.
+ */
+
+#if defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
+
+#include "twe_common.hpp"
+#include "twe_firmprog.hpp"
+#include "serial_ftdi.hpp"
+#include "modctrl_ftdi.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace TWE {
+	/**
+	 * @class	BatchProg
+	 *
+	 * @brief	Programs the same firmware through several FTDI adapters concurrently.
+	 * 			begin() starts workers, then poll get_count()/get_state()/get_progress()
+	 * 			until is_running() becomes false.
+	 */
+	class BatchProg {
+	public:
+		static const int MAX_DEVICES = 8;
+
+		enum class E_STATE {
+			WAIT = 0,	// not started
+			RUNNING,
+			SUCCESS,
+			ERROR_OPEN,	// cannot open the device or the file
+			ERROR_PROG	// error while programming
+		};
+
+	private:
+		struct _worker {
+			char devname[ISerial::tsAryChar32_MAXLEN];
+			SerialFtdi ser;
+			TweModCtlFTDI modc;
+			TweProg prog;
+			std::thread th;
+
+			std::atomic<E_STATE> state;
+			std::atomic<int> progress; // 0..1024 (over all passes)
+			std::atomic<TweProg::E_ST_TWEBLP> step; // the last protocol step
+			int n_pass; // count of passes over the blocks (compare, write, verify)
+			int i_pass; // the current pass
+			TweProg::E_ST_TWEBLP step_pass; // the step of the current pass
+			uint32_t serial_number; // the module (valid after SUCCESS)
+			uint32_t t_elapsed; // in ms
+
+			_worker(const char* name);
+			static void cb_protocol(TweProg::E_ST_TWEBLP cmd, int req_or_resp, TWE::APIRET evarg, TWEUTILS::SmplBuf_Byte& payl, void* pobj);
+		};
+
+		std::vector<std::unique_ptr<_worker>> _workers;
+		TWEUTILS::SmplBuf_WChar _file;
+		bool _b_diff;
+		bool _b_verify;
+		uint8_t _n_window;
+		std::atomic<int> _n_running;
+
+		void _run(_worker& w);
+		void _write_log(const char* path);
+
+	public:
+		BatchProg() : _workers(), _file(), _b_diff(false), _b_verify(true), _n_window(1), _n_running(0) {}
+		~BatchProg() { join(); }
+
+		/**
+		 * @fn	int BatchProg::begin(const char* file, int max_devices = MAX_DEVICES, bool b_diff = false);
+		 *
+		 * @brief	Starts programming the firmware into modules of all attached adapters.
+		 * 			Adapters opened by others (e.g. Serial2) cannot be used, close them in advance.
+		 *
+		 * @param	file	   	The firmware file (UTF-8).
+		 * @param	max_devices	max count of adapters to use.
+		 * @param	b_diff	   	compares the flash first, then erases and writes only changed sectors.
+		 *
+		 * @returns	count of started workers, 0 if no adapter or still running.
+		 */
+		int begin(const char* file, int max_devices = MAX_DEVICES, bool b_diff = false);
+
+		/**
+		 * @fn	void BatchProg::join(const char* log_path = nullptr);
+		 *
+		 * @brief	Waits for all workers, then appends the results to the log file (CSV) if given.
+		 *
+		 * @param	log_path	(Optional) The log file.
+		 */
+		void join(const char* log_path = nullptr);
+
+		// the write window of each worker (see TweProg::set_write_window()), applied at the next begin().
+		inline void set_write_window(int n) {
+			_n_window = uint8_t(n < 1 ? 1 : (n > TweProg::sFirm::WINDOW_MAX ? TweProg::sFirm::WINDOW_MAX : n));
+		}
+		inline uint8_t get_write_window() const { return _n_window; }
+
+		// reads back and verifies after writing (default: true), applied at the next begin().
+		inline void set_verify(bool b) { _b_verify = b; }
+		inline bool get_verify() const { return _b_verify; }
+
+		inline bool is_running() const { return _n_running.load() > 0; }
+
+		inline int get_count() const { return int(_workers.size()); }
+		inline const char* get_devname(int i) const { return _workers[i]->devname; }
+		inline E_STATE get_state(int i) const { return _workers[i]->state.load(); }
+		inline TweProg::E_ST_TWEBLP get_step(int i) const { return _workers[i]->step.load(); }
+		inline int get_progress(int i) const { return _workers[i]->progress.load(); }
+		inline uint32_t get_serial_number(int i) const { return _workers[i]->serial_number; }
+		inline uint32_t get_elapsed(int i) const { return _workers[i]->t_elapsed; }
+
+		// the average progress of all workers (0..1024).
+		int get_progress_total() const;
+
+		// count of workers finished with the state s.
+		int count_state(E_STATE s) const;
+
+		static const char* state_name(E_STATE s);
+	};
+}
+
+#endif //WIN/MAC/LINUX
@@ -0,0 +1,422 @@
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+/*
+ * The main loop of the headless build (HEADLESS=1), instead of sdl2_main.cpp.
+ *   - no SDL (no window, no renderer, no textures).
+ *   - TWEARD::LcdScreen is a null sink (see generic_lcd_screen.hpp), the sketch runs as is.
+ *   - the console shows data from TWE (Serial2). key input of the console is the keyboard of the sketch
+ *     (as the window of sdl2_main.cpp), so the menus can be operated and the terminal apps send it to TWE.
+ *     arrow keys, ESC, Alt(ESC)+a/b/c as the button A/B/C (+A/B/C long press), Ctrl+C exits.
+ *   - options: -c file (capture the serial input), -p file (replay a capture), -x speed (replay speed),
+ *     -k keys (typed into the sketch one by one at start, e.g. to select the port and the app).
+ *   - batch programming: -b firmware [-L logfile] [-d] writes the firmware through all attached adapters
+ *     and exits (0: all succeeded), without running the sketch. -d rewrites only changed sectors.
+ */
+
+#if (defined(__APPLE__) || defined(__linux)) && defined(MWM5_HEADLESS)
+
+ // version
+#include "version_weak.h"
+
+/*****************************************************************
+ * HEADER FILES
+ *****************************************************************/
+#include <signal.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+
+#include "mwm50.h"
+#include "M5Stack.h"
+#include "twe_sdl_m5.h"
+
+#if defined(__APPLE__)
+#include "../mac/osx_term.hpp"
+#elif defined(__linux)
+#include "../linux/linux_term.hpp"
+#endif
+
+#include "modctrl_ftdi.hpp"
+#include "serial_ftdi.hpp"
+#include "serial_capture.hpp"
+#include "batch_prog.hpp"
+#include "sdl2_clipboard.hpp"
+
+#include "twe_sys.hpp"
+
+// include getopt.c
+#include "../oss/oss_getopt.h"
+
+/***********************************************************
+ * PROTOTYPES
+ ***********************************************************/
+static void s_getopt(int argc, char* args[]);
+static void s_init();
+static int s_batch_main();
+static void s_sketch_loop();
+static void s_console_keys();
+static void signalHandler(int signum);
+
+/***********************************************************
+ * VARIABLES
+ ***********************************************************/
+
+// exit flag
+bool g_quit_sdl_loop = false;
+
+// batch programming (-b, -L, -d, -w, -n)
+static const char* s_batch_file = nullptr;
+static const char* s_batch_log = "batch_prog.log";
+static bool s_batch_diff = false;
+static int s_batch_window = 1;
+static bool s_batch_verify = true;
+
+// console
+#if defined(__APPLE__)
+TWETerm_MacConsole con_screen(80, 24);
+#elif defined(__linux)
+TWETerm_LinuxConsole con_screen(80, 24);
+#endif
+ITerm& TWETERM::the_sys_console = con_screen; // global object reference of system console.
+TWECUI::KeyInput TWE::the_sys_keyboard(512); // cosole keyboard buffer (mainly for debugging use)
+
+// the keyboard of the sketch (fed by the console, see s_console_keys())
+static TWECUI::KeyInput s_keyboard_headless(128);
+TWECUI::KeyInput& TWE::the_keyboard = s_keyboard_headless;
+
+// keys typed at start (-k), one key per KEYS_INTERVAL_ms (the list views wait a bit after the selection)
+static const char* s_start_keys = nullptr;
+static const uint32_t KEYS_INTERVAL_ms = 500;
+
+TWE_GetChar_CONIO con_keyboard;
+TWE_PutChar_CONIO TWE::WrtCon;
+
+// The Serial Device
+SerialFtdi Serial;
+SerialFtdi Serial2;
+TWE_PutChar_Serial<SerialFtdi> TWE::WrtTWE(Serial2);
+
+// TWE BOOTLOADER PROTOCOL
+TweModCtlFTDI obj_ftdi(Serial2);
+TweProg TWE::twe_prog(new TweBlProtocol<TWE::SerialFtdi, TweModCtlFTDI>(Serial2, obj_ftdi));
+
+// the M5 stack instance (the LCD is a null sink)
+M5Stack M5(320, 240);
+
+// clipboard (nothing to copy/paste)
+void TWE::twe_clipboard::_copy::copy_to_clip(const char* str) {
+	_breq = false;
+}
+void TWE::twe_clipboard::_paste::past_from_clip() {}
+twe_clipboard TWE::the_clip;
+
+/***********************************************************
+ * IMPLEMENTATION
+ ***********************************************************/
+
+// handle terminal Ctrl+C
+static void signalHandler(int signum) {
+	if (signum == SIGINT || signum == SIGQUIT) {
+		g_quit_sdl_loop = true;
+	}
+}
+
+// initialize
+static void s_init() {
+	// set dir
+	the_cwd.begin();
+#ifndef _DEBUG
+	the_cwd.change_dir(the_cwd.get_dir_exe());
+#endif
+
+	// capture Ctrl+C on the console
+	signal(SIGINT, signalHandler);
+	signal(SIGQUIT, signalHandler);
+
+	// the OS dependent initialize
+	TWESYS::SysInit();
+
+	// prepare serial port
+	SerialFtdi::list_devices();
+	Serial2.set_reader_thread(true);
+}
+
+/**
+ * @fn	static int s_batch_main()
+ *
+ * @brief	Batch programming, shows the progress of each adapter once a second.
+ *
+ * @returns	0 if all adapters succeeded, otherwise 1.
+ */
+static int s_batch_main() {
+	signal(SIGINT, signalHandler);
+	signal(SIGQUIT, signalHandler);
+	TWESYS::SysInit();
+
+	BatchProg batch;
+	batch.set_write_window(s_batch_window);
+	batch.set_verify(s_batch_verify);
+	int n = batch.begin(s_batch_file, BatchProg::MAX_DEVICES, s_batch_diff);
+	if (n == 0) {
+		fprintf(stderr, "no adapter found.\n");
+		return 1;
+	}
+	printf("writing %s with %d adapter(s), write window %d%s%s...\n", s_batch_file, n, int(batch.get_write_window())
+		, s_batch_diff ? ", changed sectors only" : "", batch.get_verify() ? ", verify" : "");
+
+	uint32_t t_disp = 0;
+	while (batch.is_running()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		if (g_quit_sdl_loop) break; // the workers can't be stopped, wait for them at join().
+
+		if (millis() - t_disp >= 1000) {
+			t_disp = millis();
+			printf("%3d%%", batch.get_progress_total() * 100 / 1024);
+			for (int i = 0; i < n; i++) {
+				printf(" [%s %s %d%%]", batch.get_devname(i)
+					, BatchProg::state_name(batch.get_state(i)), batch.get_progress(i) * 100 / 1024);
+			}
+			printf("\n");
+			fflush(stdout);
+		}
+	}
+
+	batch.join(s_batch_log);
+
+	// the results
+	for (int i = 0; i < n; i++) {
+		printf("%-10s %08X %-8s %5ums\n", batch.get_devname(i), batch.get_serial_number(i)
+			, BatchProg::state_name(batch.get_state(i)), batch.get_elapsed(i));
+	}
+	int n_ok = batch.count_state(BatchProg::E_STATE::SUCCESS);
+	printf("%d/%d succeeded (log: %s)\n", n_ok, n, s_batch_log);
+
+	return n_ok == n ? 0 : 1;
+}
+
+static void s_sketch_loop() {
+	// update tick counter
+	u32TickCount_ms = TWESYS::u32GetTick_ms();
+
+	// get serial2 buffer
+	int nSer2 = Serial2.update();
+
+	// feed the replay (read by loop() as if received from TWE)
+	int nReplay = the_replay.is_opened() ? the_replay.update() : 0;
+	static bool b_replay_end = false;
+
+	if (!twe_prog.is_protocol_busy()) {
+		// handle serial input from TWE
+		for (int i = 0; i < nSer2; i++) {
+			con_screen << char_t(Serial2._get_last_buf(i));
+		}
+		for (int i = 0; i < nReplay; i++) {
+			con_screen << char_t(the_replay._get_last_buf(i));
+		}
+		if (the_replay.is_opened() && !b_replay_end && the_replay.is_end()) {
+			con_screen << crlf << "*** end of replay ***" << crlf;
+			b_replay_end = true;
+		}
+
+		// handle console input
+		s_console_keys();
+
+		con_screen.refresh();
+	}
+
+	::loop(); // external loop()
+}
+
+/**
+ * @fn	static void s_console_keys()
+ *
+ * @brief	Pass the console key input (and the keys of -k) to the sketch keyboard.
+ * 			The console is in raw mode, the escape sequences are translated here
+ * 			(a sequence is read at once, a single ESC is KEY_ESC).
+ */
+static void s_console_keys() {
+	// keys given by -k
+	static uint32_t t_key = 0;
+	if (s_start_keys && *s_start_keys && millis() - t_key >= KEYS_INTERVAL_ms) {
+		t_key = millis();
+		int c = (unsigned char)*s_start_keys++;
+		the_keyboard.push(c == '\n' ? TWECUI::KeyInput::KEY_ENTER : c);
+	}
+
+	int c_next = -1; // a byte read after ESC, but not a part of the sequence
+	while (1) {
+		int c = c_next != -1 ? c_next : con_keyboard.get_a_byte();
+		c_next = -1;
+		if (c == -1) break;
+
+		int key = c & 0xFF;
+		switch (key) {
+		case 0x03: // Ctrl+C (no SIGINT in raw mode)
+			g_quit_sdl_loop = true;
+			return;
+		case '\n': key = TWECUI::KeyInput::KEY_ENTER; break;
+		case 0x7F: key = TWECUI::KeyInput::KEY_BS; break;
+		case TWECUI::KeyInput::KEY_ESC:
+			c = con_keyboard.get_a_byte();
+			if (c == '[' || c == 'O') {
+				// cursor keys (ESC [ A, or ESC O A in the application mode)
+				switch (con_keyboard.get_a_byte()) {
+				case 'A': key = TWECUI::KeyInput::KEY_UP; break;
+				case 'B': key = TWECUI::KeyInput::KEY_DOWN; break;
+				case 'C': key = TWECUI::KeyInput::KEY_RIGHT; break;
+				case 'D': key = TWECUI::KeyInput::KEY_LEFT; break;
+				default: key = -1; break; // not supported
+				}
+			}
+			else switch (c) {
+			// Alt+key as the buttons of M5Stack
+			case 'a': key = TWECUI::KeyInput::KEY_BUTTON_A; break;
+			case 'b': key = TWECUI::KeyInput::KEY_BUTTON_B; break;
+			case 'c': key = TWECUI::KeyInput::KEY_BUTTON_C; break;
+			case 'A': key = TWECUI::KeyInput::KEY_BUTTON_A_LONG; break;
+			case 'B': key = TWECUI::KeyInput::KEY_BUTTON_B_LONG; break;
+			case 'C': key = TWECUI::KeyInput::KEY_BUTTON_C_LONG; break;
+			default: c_next = c; break; // ESC key (and the next one)
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (key != -1) the_keyboard.push(key);
+	}
+}
+
+// no window events in the headless build.
+void push_window_event(int32_t code, void* data1, void* data2) {}
+
+int TWESYS::Get_Logical_CPU_COUNT() {
+	int n = int(std::thread::hardware_concurrency());
+	return n > 0 ? n : 1;
+}
+
+/**
+ * @fn	static void s_getopt(int argc, char* args[])
+ *
+ * @brief	getopts using oss_getopt(), opens capture/replay files.
+ *
+ * @param 		  	argc	The argc.
+ * @param [in,out]	args	If non-null, the arguments.
+ */
+static void s_getopt(int argc, char* args[]) {
+	const char* capture_file = nullptr;
+	const char* replay_file = nullptr;
+	double replay_speed = 1.0;
+	double replay_seek = 0;
+	bool replay_loop = false;
+
+	int opt = 0;
+	ts_opt_getopt* popt = oss_getopt_ref();
+
+	while ((opt = oss_getopt(argc, args, "c:p:x:s:lk:b:L:dw:n")) != -1) {
+		switch (opt) {
+		case 'c': // capture the serial input into the file
+			capture_file = popt->optarg;
+			break;
+		case 'p': // replay the serial input from the capture file
+			replay_file = popt->optarg;
+			break;
+		case 'x': // replay speed (1.0: as recorded, 0: as fast as possible)
+			replay_speed = atof(popt->optarg);
+			break;
+		case 's': // replay from the seconds since the recording start
+			replay_seek = atof(popt->optarg);
+			break;
+		case 'l': // replay again at the end
+			replay_loop = true;
+			break;
+		case 'k': // keys typed at start ('\n' or '\r' as Enter)
+			s_start_keys = popt->optarg;
+			break;
+		case 'b': // batch programming of the firmware file
+			s_batch_file = popt->optarg;
+			break;
+		case 'L': // the result log of batch programming
+			s_batch_log = popt->optarg;
+			break;
+		case 'd': // batch programming of changed sectors only
+			s_batch_diff = true;
+			break;
+		case 'w': // batch programming with requests sent ahead of the responses (1..4)
+			s_batch_window = atoi(popt->optarg);
+			break;
+		case 'n': // batch programming without verify (reading back)
+			s_batch_verify = false;
+			break;
+		default: /* '?' */
+			fprintf(stderr, "Usage: %s [-c capture_file] [-p replay_file [-x speed] [-s secs] [-l]] [-k keys] [-b firmware [-L logfile] [-d] [-w window] [-n]]\n", args[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (capture_file && !the_capture.open(capture_file)) {
+		fprintf(stderr, "cannot create the capture file: %s\n", capture_file);
+	}
+	if (replay_file) {
+		if (the_replay.open(replay_file)) {
+			if (replay_seek > 0) the_replay.seek(uint32_t(replay_seek * 1000));
+			the_replay.set_speed(replay_speed);
+			the_replay.set_loop(replay_loop);
+		}
+		else fprintf(stderr, "cannot open the capture file: %s\n", replay_file);
+	}
+}
+
+/**
+ * @fn	int main(int argc, char* args[])
+ *
+ * @brief	Main entry-point for the headless build
+ *
+ * @param	argc	The number of command-line arguments provided.
+ * @param	args	An array of command-line argument strings.
+ *
+ * @returns	Exit-code for the process - 0 for success, else an error code.
+ */
+int main(int argc, char* args[]) {
+	// check command line args (capture/replay files are opened before changing the dir)
+	s_getopt(argc, args);
+
+	// batch programming (paths are relative to the current dir)
+	if (s_batch_file) {
+		return s_batch_main();
+	}
+
+	printf("\033[2J\033[H");
+
+	// initialize
+	s_init();
+
+	// console setup
+	con_screen.setup();
+	con_screen << printfmt("*** TWELITE STAGE (v%d-%d-%d, headless) ***", MWM5_APP_VERSION_MAIN, MWM5_APP_VERSION_SUB, MWM5_APP_VERSION_VAR) << crlf;
+
+	// call sketch setup();
+	::setup();
+
+	// main loop (no rendering, wait a bit when idle)
+	while (!g_quit_sdl_loop) {
+		s_sketch_loop();
+
+		if (!twe_prog.is_protocol_busy() && !Serial2.available()) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	// on exit
+	the_capture.close(); // writes the index (_exit() skips destructors)
+	con_screen << crlf << "exiting" << crlf;
+	con_screen.refresh();
+	con_screen.close_term(); // shall take the screen back before calling _exit().
+
+	_exit(0);
+	return 0;
+}
+
+#endif // MWM5_HEADLESS
@@ -49,6 +49,7 @@
 
 #include "modctrl_ftdi.hpp"
 #include "serial_ftdi.hpp"
+#include "serial_capture.hpp"
 #include "esp32/esp32_lcd_color.h"
 
 #include "twe_sys.hpp"
@@ -58,6 +59,7 @@
 #include "sdl2_button.hpp"
 #include "sdl2_keyb.hpp"
 #include "sdl2_icon.h"
+#include "sdl2_pixkern.hpp"
 
 // include getopt.c
 #include "../oss/oss_getopt.h"
@@ -141,8 +143,16 @@ M5Stack M5(M5_LCD_WIDTH, M5_LCD_HEIGHT);
 // settings from getopt
 struct _gen_preference {
 	int render_engine; // choose rendering option (osx Metal)
+	int render_fps; // max frame rate of rendering (0: render every loop, waiting VSYNC)
+	const char* capture_file; // record the serial input into the file (-c)
+	const char* replay_file; // replay the serial input from the capture file (-p)
+	double replay_speed; // replay speed (1.0: as recorded, 0: as fast as possible)
+	double replay_seek; // start the replay from the time in seconds since the recording start (-s)
+	bool replay_loop; // replay again at the end (-l)
 } the_pref;
 
+static const int RENDER_FPS_DEFAULT = 60;
+
 /***********************************************************
  * ICON
  ***********************************************************/
@@ -955,108 +965,66 @@ struct app_core_sdl {
 	}
 
 	void render_main_screen() {
-		// texture source rect
-		const SDL_Rect* p_srcrect = NULL;
-
-		// the start of texure update by memory update.
-		void* mPixels;
-		int mPitch;
-		SDL_LockTexture( mTexture, NULL, &mPixels, &mPitch );
-			
-		if (render_mode_m5_main == 0) {
-			static const SDL_Rect srcrect = { 0, 0, M5_LCD_WIDTH * 2, M5_LCD_HEIGHT * 2 };
-			p_srcrect = &srcrect;
-
-			for (int y = 0; y < M5_LCD_HEIGHT; y++) {
-				if (M5.Lcd.update_line(y)) {
-					uint32_t* p1 = (uint32_t*)mPixels + (y * M5_LCD_WIDTH * 4);
-					uint32_t* p2 = p1 + (M5_LCD_WIDTH * 2);
-
-					for (int x = 0; x < M5_LCD_WIDTH; x++) {
-						auto c = M5.Lcd.get_pt(x, y);
-
-						// RENDER LIKE LCD
-						draw_point(p1, c);
-						draw_point(p1+1, c, 192);
-						draw_point(p2, c, 128);
-						draw_point(p2+1, c, 128);
-
-						p1 += 2;
-						p2 += 2;
-					}
-				}
-			}
-		} else if (render_mode_m5_main == 1) {
-			static const SDL_Rect srcrect = { 0, 0, M5_LCD_WIDTH, M5_LCD_HEIGHT * 2 };
-			p_srcrect = &srcrect;
-
-			for (int y = 0; y < M5_LCD_HEIGHT; y++) {
-				if (M5.Lcd.update_line(y)) {
-					uint32_t* p1 = (uint32_t*)mPixels + (y * M5_LCD_WIDTH * 4);
-					uint32_t* p2 = p1 + (M5_LCD_WIDTH * 2);
-
-					for (int x = 0; x < M5_LCD_WIDTH; x++) {
-						RGBA c = M5.Lcd.get_pt(x, y);
-						
-						draw_point(p1, c);
-						draw_point(p2, c, 128);
+		// texture source rect and the scale of LCD pixels on the texture.
+		static const SDL_Rect srcrect_mode[4] = {
+			{ 0, 0, M5_LCD_WIDTH * 2, M5_LCD_HEIGHT * 2 },	// 0: like LCD
+			{ 0, 0, M5_LCD_WIDTH,     M5_LCD_HEIGHT * 2 },	// 1: scan line
+			{ 0, 0, M5_LCD_WIDTH,     M5_LCD_HEIGHT     },	// 2: blur
+			{ 0, 0, M5_LCD_WIDTH * 2, M5_LCD_HEIGHT * 2 },	// 3: like digital texture
+		};
+		static const int scale_x[4] = { 2, 1, 1, 2 };
+		static const int scale_y[4] = { 2, 2, 1, 2 };
+
+		const int mode = (render_mode_m5_main >= 0 && render_mode_m5_main < 4) ? render_mode_m5_main : 0;
+		const SDL_Rect* p_srcrect = &srcrect_mode[mode];
+		const int sx = scale_x[mode], sy = scale_y[mode];
+
+		// the damaged area, update only this area of the texture.
+		Rect dmg;
+		if (M5.Lcd.get_damage(dmg)) {
+			const SDL_Rect lockrect = { dmg.x * sx, dmg.y * sy, dmg.w * sx, dmg.h * sy };
 
-						p1 += 1;
-						p2 += 1;
+			// the start of texure update by memory update.
+			void* mPixels;
+			int mPitch;
+			if (SDL_LockTexture(mTexture, &lockrect, &mPixels, &mPitch) == 0) {
+				for (int y = dmg.y; y < dmg.y + dmg.h; y++) {
+					int32_t x0, x1;
+					if (!M5.Lcd.update_line(y, x0, x1)) continue;
+
+					// mPixels points the top-left of lockrect, mPitch is of the whole texture.
+					uint32_t* p1 = (uint32_t*)((uint8_t*)mPixels + (y - dmg.y) * sy * mPitch) + (x0 - dmg.x) * sx;
+					uint32_t* p2 = (uint32_t*)((uint8_t*)p1 + mPitch);
+
+					const RGBA* src = M5.Lcd.get_line(y) + x0;
+					const int n = x1 - x0 + 1;
+
+					switch (mode) {
+					case 0: // RENDER LIKE LCD
+						pixkern::row_x2(p1, src, n, 0xFF, 192);
+						pixkern::row_x2(p2, src, n, 128, 128);
+						break;
+					case 1: // SCAN LINE
+						pixkern::row_x1(p1, src, n);
+						pixkern::row_x1(p2, src, n, 128);
+						break;
+					case 2: // RENDER BLUR
+						pixkern::row_x1(p1, src, n);
+						break;
+					case 3: // RENDER LIKE DIGITAL TEXTURE
+						pixkern::row_x2(p1, src, n);
+						memcpy(p2, p1, n * 2 * sizeof(uint32_t));
+						break;
 					}
 				}
-			}
-		} else if (render_mode_m5_main == 2) {
-			static const SDL_Rect srcrect = { 0, 0, M5_LCD_WIDTH, M5_LCD_HEIGHT };
-			p_srcrect = &srcrect;
-
-			for (int y = 0; y < M5_LCD_HEIGHT; y++) {
-				if (M5.Lcd.update_line(y)) {
-					uint32_t* p1 = (uint32_t*)mPixels + (y * M5_LCD_WIDTH * 2);
-					uint32_t* p2 = p1 + (M5_LCD_WIDTH * 1);
-
-					for (int x = 0; x < M5_LCD_WIDTH; x++) {
-						auto c = M5.Lcd.get_pt(x, y);
-
-						// RENDER BLUR
-						draw_point(p1, c);
-						draw_point(p2, c);
 
-						p1 += 1;
-						p2 += 1;
-					}
-				}
+				// the end of texture update by memory update
+				SDL_UnlockTexture(mTexture);
 			}
 
-		} else
-		if (render_mode_m5_main == 3) {
-			static const SDL_Rect srcrect = { 0, 0, M5_LCD_WIDTH * 2, M5_LCD_HEIGHT * 2 };
-			p_srcrect = &srcrect;
-								
-			for (int y = 0; y < M5_LCD_HEIGHT; y++) {
-				if (M5.Lcd.update_line(y)) {
-					uint32_t* p1 = (uint32_t*)mPixels + (y * M5_LCD_WIDTH * 4);
-					uint32_t* p2 = p1 + (M5_LCD_WIDTH * 2);
-
-					for (int x = 0; x < M5_LCD_WIDTH; x++) {
-						auto c = M5.Lcd.get_pt(x, y);
-
-						// RENDER LIKE DIGITAL TEXTURE
-						draw_point(p1, c);
-						draw_point(p1+1, c);
-						draw_point(p2, c);
-						draw_point(p2+1, c);
-
-						p1 += 2;
-						p2 += 2;
-					}
-				}
-			}
+			M5.Lcd.clear_damage();
 		}
 
-		// the end of texture update by memory update
-		SDL_UnlockTexture(mTexture);
-
 		//Reset render target
 		SDL_SetRenderTarget(gRenderer, nullptr);
 
@@ -1158,15 +1126,33 @@ struct app_core_sdl {
 
 		SDL_Point screenCenter = { SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 };
 
+		// render tick (if render_fps == 0, render every loop and wait VSYNC at SDL_RenderPresent())
+		const uint32_t u32render_interval = the_pref.render_fps > 0 ? 1000 / the_pref.render_fps : 0;
+		uint32_t u32render_last = SDL_GetTicks() - u32render_interval;
+		bool b_need_render = true;
+
 		while (g_quit_sdl_loop == false || quit_loop_count > 0) {
 			//Event handler
 			while (SDL_PollEvent(&e) != 0) {
 				handle_sdl_event(e);	
+				b_need_render = true;
 			}
 
-			// SKETCH WORKS
+			// SKETCH WORKS (I/O, processing tick: runs as fast as data arrives)
 			::s_sketch_loop();
 
+			// render tick
+			uint32_t u32now = SDL_GetTicks();
+			if (u32now - u32render_last < u32render_interval) {
+				// wait a bit for the next data or events, unless in the bootloader protocol.
+				if (!twe_prog.is_protocol_busy() && SDL_WaitEventTimeout(&e, 1)) {
+					handle_sdl_event(e);
+					b_need_render = true;
+				}
+				continue;
+			}
+			u32render_last = u32now;
+
 			// Update Alt Screen	
 			static FT_HANDLE ser2handle = (FT_HANDLE)(-1);
 			if (Serial2.get_handle() != ser2handle) {
@@ -1178,6 +1164,18 @@ struct app_core_sdl {
 			sub_screen_br.refresh();
 			sub_textediting.refresh();
 
+			// skip rendering, if nothing is changed.
+			if (u32render_interval > 0 && !b_need_render
+				&& !M5.Lcd.is_dirty()
+				&& !(nAltDown && M5_SUB.Lcd.is_dirty())
+				&& !(nTextEditing && M5_TEXTE.Lcd.is_dirty())
+				&& nAltDown >= 0 && nTextEditing >= 0 // fading
+				&& quit_loop_count < 0 && !g_quit_sdl_loop
+			) {
+				continue;
+			}
+			b_need_render = false;
+
 			// clear back margin
 			if (_bfullscr > 0 && (SCREEN_POS_X != 0 || SCREEN_POS_Y != 0)) {
 				Uint8 r, g, b, a;
@@ -1281,6 +1279,7 @@ static void s_init() {
 	
 	// prepare serial port
 	SerialFtdi::list_devices();
+	Serial2.set_reader_thread(true); // read the device apart from the render loop
 }
 
 static void s_init_sdl() {
@@ -1346,7 +1345,8 @@ static void s_init_sdl() {
 #endif
 
 	// Renderer
-	gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+	// VSYNC only if rendering every loop (otherwise, the loop is paced by the render tick)
+	gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED | (the_pref.render_fps == 0 ? SDL_RENDERER_PRESENTVSYNC : 0));
 
 	if (gRenderer == NULL)
 		exit_err("SDL_CreateRenderer()");
@@ -1369,6 +1369,10 @@ static void s_sketch_loop() {
 	// get serial2 buffer
 	int nSer2 = Serial2.update();
 
+	// feed the replay (read by loop() as if received from TWE)
+	int nReplay = the_replay.is_opened() ? the_replay.update() : 0;
+	static bool b_replay_end = false;
+
 	// console test
 	if (!twe_prog.is_protocol_busy()) {
 		// handle serial input from TWE
@@ -1377,6 +1381,13 @@ static void s_sketch_loop() {
 				con_screen << char_t(Serial2._get_last_buf(i));
 			}
 		}
+		for (int i = 0; i < nReplay; i++) {
+			con_screen << char_t(the_replay._get_last_buf(i));
+		}
+		if (the_replay.is_opened() && !b_replay_end && the_replay.is_end()) {
+			con_screen << crlf << "*** end of replay ***" << crlf;
+			b_replay_end = true;
+		}
 
 		// handle console input
 		while (1) {
@@ -1436,19 +1447,24 @@ static void s_sketch_loop() {
 		::loop(); // external loop()
 	} else {
 		// is in bootloader protocol.
-		// too make it faster, process a bulk of command at one time, otherwise it's affected by VSYNC wait.
-		static int ct = 0; // bulk process counter
-		
-		// more loop
-		do {
-			if (Serial2.update() > 0) ct++;
+		if (the_pref.render_fps == 0) {
+			// rendering every loop with VSYNC wait, process a bulk of command at one time.
+			static int ct = 0; // bulk process counter
+
+			// more loop
+			do {
+				if (Serial2.update() > 0) ct++;
+				::loop();
+
+				if (ct >= 4) { // process 4 commands at every loop.
+					ct = 0;
+					break;
+				}
+			} while (twe_prog.is_protocol_busy());
+		} else {
+			// the loop is not paced by rendering, process one at a time.
 			::loop();
-
-			if (ct >= 4) { // process 4 commands at every loop.
-				ct = 0;
-				break;
-			}
-		} while (twe_prog.is_protocol_busy());
+		}
 	}	
 }
 
@@ -1462,19 +1478,41 @@ static void s_sketch_loop() {
  */
 static void s_getopt(int argc, char* args[]) {
 	memset(&the_pref, 0, sizeof(the_pref));
+	the_pref.render_fps = RENDER_FPS_DEFAULT;
+	the_pref.replay_speed = 1.0;
 	
 	int opt = 0;
 	ts_opt_getopt* popt = oss_getopt_ref();
 
-    while ((opt = oss_getopt(argc, args, "nR:")) != -1) {
+    while ((opt = oss_getopt(argc, args, "nR:F:c:p:x:s:l")) != -1) {
         switch (opt) {
         case 'n': // single arg
             break;
         case 'R': // Render engine (0:default 1:opengl 2:metal)
             the_pref.render_engine = atoi(popt->optarg);
             break;
+        case 'F': // max render rate in fps (0: every loop with VSYNC)
+            the_pref.render_fps = atoi(popt->optarg);
+            if (the_pref.render_fps < 0) the_pref.render_fps = 0;
+            if (the_pref.render_fps > 1000) the_pref.render_fps = 1000;
+            break;
+        case 'c': // capture the serial input into the file
+            the_pref.capture_file = popt->optarg;
+            break;
+        case 'p': // replay the serial input from the capture file
+            the_pref.replay_file = popt->optarg;
+            break;
+        case 'x': // replay speed
+            the_pref.replay_speed = atof(popt->optarg);
+            break;
+        case 's': // replay from the seconds since the recording start
+            the_pref.replay_seek = atof(popt->optarg);
+            break;
+        case 'l': // replay again at the end
+            the_pref.replay_loop = true;
+            break;
         default: /* '?' */
-            fprintf(stderr, "Usage: %s [-t nsecs] [-n] name\n",
+            fprintf(stderr, "Usage: %s [-R engine] [-F fps] [-c capture_file] [-p replay_file [-x speed] [-s secs] [-l]]\n",
                     args[0]);
             exit(EXIT_FAILURE);
         }
@@ -1525,6 +1563,19 @@ int main(int argc, char* args[]) {
 	// check command line agrs
 	s_getopt(argc, args);
 
+	// capture/replay files (before changing the dir, the path is relative to the current dir)
+	if (the_pref.capture_file && !the_capture.open(the_pref.capture_file)) {
+		fprintf(stderr, "cannot create the capture file: %s\n", the_pref.capture_file);
+	}
+	if (the_pref.replay_file) {
+		if (the_replay.open(the_pref.replay_file)) {
+			if (the_pref.replay_seek > 0) the_replay.seek(uint32_t(the_pref.replay_seek * 1000));
+			the_replay.set_speed(the_pref.replay_speed);
+			the_replay.set_loop(the_pref.replay_loop);
+		}
+		else fprintf(stderr, "cannot open the capture file: %s\n", the_pref.replay_file);
+	}
+
 	printf("\033[2J\033[H");
 
 	// initialize
@@ -1545,6 +1596,7 @@ int main(int argc, char* args[]) {
 	the_app_core.loop();
 
 	// on exit 
+	the_capture.close(); // writes the index (_exit() skips destructors)
 	con_screen.close_term(); // shall take the screen back before calling _exit().
 
 #if defined(__APPLE__) || defined(__linux)
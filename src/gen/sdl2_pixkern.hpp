@@ -0,0 +1,146 @@
+#pragma once
+
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+/*
+ * Row kernels converting LCD pixels (RGBA) into the SDL texture pixels (RGBA8888).
+ *   - a texture pixel is { 0xFF, B, G, R } in memory (the byte order of draw_point() in sdl2_main.cpp).
+ *   - with dimming, each color is (c * lumi) >> 8, alpha is always 0xFF.
+ *   - the scalar reference is in pixkern_ref::, vectorized ones (SSE2/NEON) are pixkern::,
+ *     both must produce the bit exact same output.
+ */
+
+#if defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
+
+#include "twe_common.hpp"
+#include "esp32/generic_lcd_common.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define MWM5_PIXKERN_SSE2
+# include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define MWM5_PIXKERN_NEON
+# include <arm_neon.h>
+#endif
+
+namespace pixkern_ref {
+	// a pixel (same as draw_point())
+	static inline uint32_t conv(TWEARD::RGBA c, uint8_t lumi = 0xFF) {
+		uint32_t d;
+		uint8_t* p = (uint8_t*)&d;
+
+		if (lumi == 0xFF) {
+			p[0] = 0xFF;
+			p[1] = c.u8col[2];
+			p[2] = c.u8col[1];
+			p[3] = c.u8col[0];
+		} else {
+			p[0] = 0xFF;
+			p[1] = uint8_t((c.u8col[2] * lumi) >> 8);
+			p[2] = uint8_t((c.u8col[1] * lumi) >> 8);
+			p[3] = uint8_t((c.u8col[0] * lumi) >> 8);
+		}
+
+		return d;
+	}
+
+	// dst[i] = conv(src[i], lumi), i = 0..n-1
+	static inline void row_x1(uint32_t* dst, const TWEARD::RGBA* src, int n, uint8_t lumi = 0xFF) {
+		for (int i = 0; i < n; i++) dst[i] = conv(src[i], lumi);
+	}
+
+	// dst[2i] = conv(src[i], lumi0), dst[2i+1] = conv(src[i], lumi1), i = 0..n-1
+	static inline void row_x2(uint32_t* dst, const TWEARD::RGBA* src, int n, uint8_t lumi0 = 0xFF, uint8_t lumi1 = 0xFF) {
+		for (int i = 0; i < n; i++) {
+			dst[2 * i] = conv(src[i], lumi0);
+			dst[2 * i + 1] = conv(src[i], lumi1);
+		}
+	}
+}
+
+namespace pixkern {
+#if defined(MWM5_PIXKERN_SSE2)
+	// 4 pixels: reverse bytes of each pixel, dim colors and set alpha.
+	static inline __m128i _conv4(__m128i v, uint8_t lumi) {
+		const __m128i m00ff = _mm_set1_epi32(0x00FF0000);
+		const __m128i mff00 = _mm_set1_epi32(0x0000FF00);
+
+		v = _mm_or_si128(
+				_mm_or_si128(_mm_slli_epi32(v, 24), _mm_and_si128(_mm_slli_epi32(v, 8), m00ff)),
+				_mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, 8), mff00), _mm_srli_epi32(v, 24)));
+
+		if (lumi != 0xFF) {
+			// (c * lumi) >> 8 == mulhi(c, lumi << 8)
+			const __m128i z = _mm_setzero_si128();
+			const __m128i k = _mm_set1_epi16(short(lumi << 8));
+			__m128i lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(v, z), k);
+			__m128i hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(v, z), k);
+			v = _mm_packus_epi16(lo, hi);
+		}
+
+		return _mm_or_si128(v, _mm_set1_epi32(0xFF));
+	}
+
+	static inline void row_x1(uint32_t* dst, const TWEARD::RGBA* src, int n, uint8_t lumi = 0xFF) {
+		int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+			_mm_storeu_si128((__m128i*)(dst + i), _conv4(v, lumi));
+		}
+		pixkern_ref::row_x1(dst + i, src + i, n - i, lumi);
+	}
+
+	static inline void row_x2(uint32_t* dst, const TWEARD::RGBA* src, int n, uint8_t lumi0 = 0xFF, uint8_t lumi1 = 0xFF) {
+		int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i a = _conv4(v, lumi0);
+			__m128i b = (lumi1 == lumi0) ? a : _conv4(v, lumi1);
+			_mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_unpacklo_epi32(a, b));
+			_mm_storeu_si128((__m128i*)(dst + 2 * i + 4), _mm_unpackhi_epi32(a, b));
+		}
+		pixkern_ref::row_x2(dst + 2 * i, src + i, n - i, lumi0, lumi1);
+	}
+#elif defined(MWM5_PIXKERN_NEON)
+	// 4 pixels: reverse bytes of each pixel, dim colors and set alpha.
+	static inline uint8x16_t _conv4(uint8x16_t v, uint8_t lumi) {
+		v = vrev32q_u8(v);
+
+		if (lumi != 0xFF) {
+			const uint8x8_t k = vdup_n_u8(lumi);
+			v = vcombine_u8(
+					vshrn_n_u16(vmull_u8(vget_low_u8(v), k), 8),
+					vshrn_n_u16(vmull_u8(vget_high_u8(v), k), 8));
+		}
+
+		return vorrq_u8(v, vreinterpretq_u8_u32(vdupq_n_u32(0xFF)));
+	}
+
+	static inline void row_x1(uint32_t* dst, const TWEARD::RGBA* src, int n, uint8_t lumi = 0xFF) {
+		int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			uint8x16_t v = vld1q_u8((const uint8_t*)(src + i));
+			vst1q_u8((uint8_t*)(dst + i), _conv4(v, lumi));
+		}
+		pixkern_ref::row_x1(dst + i, src + i, n - i, lumi);
+	}
+
+	static inline void row_x2(uint32_t* dst, const TWEARD::RGBA* src, int n, uint8_t lumi0 = 0xFF, uint8_t lumi1 = 0xFF) {
+		int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			uint8x16_t v = vld1q_u8((const uint8_t*)(src + i));
+			uint32x4x2_t ab;
+			ab.val[0] = vreinterpretq_u32_u8(_conv4(v, lumi0));
+			ab.val[1] = (lumi1 == lumi0) ? ab.val[0] : vreinterpretq_u32_u8(_conv4(v, lumi1));
+			vst2q_u32(dst + 2 * i, ab); // interleave
+		}
+		pixkern_ref::row_x2(dst + 2 * i, src + i, n - i, lumi0, lumi1);
+	}
+#else
+	using pixkern_ref::row_x1;
+	using pixkern_ref::row_x2;
+#endif
+}
+
+#endif
@@ -0,0 +1,354 @@
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+#if defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
+
+#include "serial_capture.hpp"
+
+#include <cstring>
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace TWE;
+
+// the instances
+CaptureWriter TWE::the_capture;
+SerialReplay TWE::the_replay;
+
+// little endian access
+static inline void s_put_u16(uint8_t* p, uint16_t v) { p[0] = uint8_t(v); p[1] = uint8_t(v >> 8); }
+static inline void s_put_u32(uint8_t* p, uint32_t v) { s_put_u16(p, uint16_t(v)); s_put_u16(p + 2, uint16_t(v >> 16)); }
+static inline void s_put_u64(uint8_t* p, uint64_t v) { s_put_u32(p, uint32_t(v)); s_put_u32(p + 4, uint32_t(v >> 32)); }
+static inline uint16_t s_get_u16(const uint8_t* p) { return uint16_t(p[0] | (p[1] << 8)); }
+static inline uint32_t s_get_u32(const uint8_t* p) { return s_get_u16(p) | (uint32_t(s_get_u16(p + 2)) << 16); }
+static inline uint64_t s_get_u64(const uint8_t* p) { return s_get_u32(p) | (uint64_t(s_get_u32(p + 4)) << 32); }
+
+static const char CAP_MAGIC[6] = { 'T', 'W', 'E', 'C', 'A', 'P' };
+static const char IDX_MAGIC[4] = { 'T', 'I', 'D', 'X' };
+static const uint8_t CAP_VERSION = 1;
+
+/*****************************************************************
+ * CaptureWriter
+ *****************************************************************/
+bool CaptureWriter::open(const char* path) {
+	close();
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	if (fopen_s(&_fp, path, "wb") != 0) _fp = nullptr;
+#else
+	_fp = fopen(path, "wb");
+#endif
+	if (_fp == nullptr) return false;
+
+	uint8_t hdr[CaptureFile::HEADER_SIZE] = {};
+	memcpy(hdr, CAP_MAGIC, sizeof(CAP_MAGIC));
+	hdr[6] = CAP_VERSION;
+	hdr[7] = 0;
+	s_put_u64(hdr + 8, uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count()));
+	fwrite(hdr, 1, sizeof(hdr), _fp);
+
+	_offset = sizeof(hdr);
+	_t0 = std::chrono::steady_clock::now();
+	_parser.reinit();
+	_idx.clear();
+	_idx_next_ms = 0;
+
+	return true;
+}
+
+void CaptureWriter::close() {
+	if (_fp == nullptr) return;
+
+	// INDEX and FOOTER (the offsets are 32bit, no index for a larger file)
+	if (_offset < 0xFFFFFFFFull) {
+		uint64_t idx_offset = _offset;
+		uint8_t b[8];
+		for (size_t i = 0; i < _idx.size(); i++) {
+			s_put_u32(b, _idx[i]);
+			fwrite(b, 1, 4, _fp);
+		}
+
+		uint8_t ftr[CaptureFile::FOOTER_SIZE];
+		s_put_u64(ftr, idx_offset);
+		s_put_u32(ftr + 8, uint32_t(_idx.size() / 2));
+		memcpy(ftr + 12, IDX_MAGIC, sizeof(IDX_MAGIC));
+		fwrite(ftr, 1, sizeof(ftr), _fp);
+	}
+
+	fclose(_fp);
+	_fp = nullptr;
+}
+
+void CaptureWriter::_write_record(uint32_t t_ms, uint8_t type, const uint8_t* p, uint16_t len) {
+	uint8_t hdr[CaptureFile::RECORD_HEADER_SIZE];
+	s_put_u32(hdr, t_ms);
+	hdr[4] = type;
+	hdr[5] = 0;
+	s_put_u16(hdr + 6, len);
+
+	fwrite(hdr, 1, sizeof(hdr), _fp);
+	if (len) fwrite(p, 1, len, _fp);
+	_offset += sizeof(hdr) + len;
+}
+
+void CaptureWriter::write(const uint8_t* p, int len) {
+	if (_fp == nullptr || len <= 0) return;
+
+	uint32_t t_ms = _now_ms();
+
+	// the index entry at every second (the first RAW record after the boundary)
+	if (t_ms >= _idx_next_ms && _offset < 0xFFFFFFFFull) {
+		_idx.push_back(t_ms);
+		_idx.push_back(uint32_t(_offset));
+		_idx_next_ms = t_ms - (t_ms % 1000) + 1000;
+	}
+
+	// RAW records (split by 64KB)
+	for (int i = 0; i < len; i += 0xFFFF) {
+		int n = len - i > 0xFFFF ? 0xFFFF : len - i;
+		_write_record(t_ms, REC_RAW, p + i, uint16_t(n));
+	}
+
+	// PAYLOAD records
+	_parser.parse(p, size_t(len), [this, t_ms](TWESERCMD::AsciiParser& parser) {
+		auto&& pl = parser.get_payload();
+		_write_record(t_ms, REC_PAYLOAD, pl.begin().raw_ptr(), uint16_t(pl.size()));
+	});
+}
+
+/*****************************************************************
+ * CaptureFile
+ *****************************************************************/
+#if defined(_MSC_VER) || defined(__MINGW32__)
+CaptureFile::CaptureFile() : _p(nullptr), _size(0), _rec_end(0), _idx(nullptr), _idx_count(0), _hfile(INVALID_HANDLE_VALUE), _hmap(NULL) {}
+#else
+CaptureFile::CaptureFile() : _p(nullptr), _size(0), _rec_end(0), _idx(nullptr), _idx_count(0), _fd(-1) {}
+#endif
+
+bool CaptureFile::open(const char* path) {
+	close();
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	_hfile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (_hfile == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER sz;
+	if (!GetFileSizeEx((HANDLE)_hfile, &sz) || sz.QuadPart < LONGLONG(HEADER_SIZE)) { close(); return false; }
+	_size = size_t(sz.QuadPart);
+
+	_hmap = CreateFileMappingA((HANDLE)_hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (_hmap == NULL) { close(); return false; }
+
+	_p = (const uint8_t*)MapViewOfFile((HANDLE)_hmap, FILE_MAP_READ, 0, 0, 0);
+	if (_p == nullptr) { close(); return false; }
+#else
+	_fd = ::open(path, O_RDONLY);
+	if (_fd < 0) return false;
+
+	struct stat st;
+	if (fstat(_fd, &st) != 0 || st.st_size < off_t(HEADER_SIZE)) { close(); return false; }
+	_size = size_t(st.st_size);
+
+	void* p = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+	if (p == MAP_FAILED) { close(); return false; }
+	_p = (const uint8_t*)p;
+	madvise(p, _size, MADV_SEQUENTIAL);
+#endif
+
+	// check the header
+	if (memcmp(_p, CAP_MAGIC, sizeof(CAP_MAGIC)) || _p[6] != CAP_VERSION) {
+		close();
+		return false;
+	}
+
+	// check the footer and the index
+	_rec_end = _size;
+	_idx = nullptr;
+	_idx_count = 0;
+	if (_size >= HEADER_SIZE + FOOTER_SIZE) {
+		const uint8_t* f = _p + _size - FOOTER_SIZE;
+		uint64_t idx_offset = s_get_u64(f);
+		uint32_t idx_count = s_get_u32(f + 8);
+
+		if (!memcmp(f + 12, IDX_MAGIC, sizeof(IDX_MAGIC))
+			&& idx_offset >= HEADER_SIZE
+			&& idx_offset + uint64_t(idx_count) * 8 + FOOTER_SIZE == _size
+		) {
+			_rec_end = size_t(idx_offset);
+			_idx = idx_count ? _p + idx_offset : nullptr;
+			_idx_count = idx_count;
+		}
+	}
+
+	return true;
+}
+
+void CaptureFile::close() {
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	if (_p) UnmapViewOfFile(_p);
+	if (_hmap != NULL) CloseHandle((HANDLE)_hmap);
+	if (_hfile != INVALID_HANDLE_VALUE) CloseHandle((HANDLE)_hfile);
+	_hmap = NULL;
+	_hfile = INVALID_HANDLE_VALUE;
+#else
+	if (_p) munmap((void*)_p, _size);
+	if (_fd >= 0) ::close(_fd);
+	_fd = -1;
+#endif
+	_p = nullptr;
+	_size = 0;
+	_rec_end = 0;
+	_idx = nullptr;
+	_idx_count = 0;
+}
+
+uint64_t CaptureFile::start_time() const {
+	return _p ? s_get_u64(_p + 8) : 0;
+}
+
+bool CaptureFile::next(size_t& pos, record& r) const {
+	if (_p == nullptr || pos + RECORD_HEADER_SIZE > _rec_end) return false;
+
+	const uint8_t* h = _p + pos;
+	r.t_ms = s_get_u32(h);
+	r.type = h[4];
+	r.len = s_get_u16(h + 6);
+	if (pos + RECORD_HEADER_SIZE + r.len > _rec_end) return false; // broken at the tail
+
+	r.data = h + RECORD_HEADER_SIZE;
+	pos += RECORD_HEADER_SIZE + r.len;
+	return true;
+}
+
+size_t CaptureFile::seek(uint32_t t_ms) const {
+	size_t pos = begin();
+
+	// start from the last index entry before t_ms
+	if (_idx) {
+		uint32_t lo = 0, hi = _idx_count; // the first entry with time > t_ms
+		while (lo < hi) {
+			uint32_t m = (lo + hi) / 2;
+			if (s_get_u32(_idx + m * 8) <= t_ms) lo = m + 1; else hi = m;
+		}
+		if (lo > 0) pos = s_get_u32(_idx + (lo - 1) * 8 + 4);
+	}
+
+	// then search linearly
+	size_t p = pos;
+	record r;
+	while (next(p, r)) {
+		if (r.type == CaptureWriter::REC_RAW && r.t_ms >= t_ms) break;
+		pos = p;
+	}
+
+	return pos;
+}
+
+/*****************************************************************
+ * SerialReplay
+ *****************************************************************/
+bool SerialReplay::open(const char* path) {
+	close();
+
+	if (!_cap.open(path)) return false;
+
+	// the base name as the device name
+	const char* b = path;
+	for (const char* p = path; *p; p++) if (*p == '/' || *p == '\\') b = p + 1;
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	strncpy_s(_devname, b, sizeof(_devname) - 1);
+#else
+	strncpy(_devname, b, sizeof(_devname) - 1);
+	_devname[sizeof(_devname) - 1] = 0;
+#endif
+
+	_pos_start = _cap.begin();
+	_rewind();
+	return true;
+}
+
+bool SerialReplay::seek(uint32_t t_ms) {
+	if (!_cap.is_opened()) return false;
+
+	_pos_start = _cap.seek(t_ms);
+	_rewind();
+	return true;
+}
+
+void SerialReplay::_rewind() {
+	_pos = _pos_start;
+	_rec_done = 0;
+
+	CaptureFile::record r;
+	size_t p = _pos;
+	_t_base = _cap.next(p, r) ? r.t_ms : 0;
+	_t0 = std::chrono::steady_clock::now();
+}
+
+void SerialReplay::_rebase() {
+	CaptureFile::record r;
+	size_t p = _pos;
+	if (_cap.next(p, r)) _t_base = r.t_ms;
+	_t0 = std::chrono::steady_clock::now();
+}
+
+bool SerialReplay::is_end() {
+	CaptureFile::record r;
+	size_t p = _pos;
+	return !_cap.next(p, r);
+}
+
+int SerialReplay::update() {
+	_buf_len = 0;
+	if (!_cap.is_opened()) return 0;
+
+	// the record time due by now
+	double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _t0).count();
+	double t_due = _t_base + elapsed * _speed;
+
+	CaptureFile::record r;
+	while (_buf_len < int(sizeof(_buf))) {
+		size_t p = _pos;
+		if (!_cap.next(p, r)) {
+			if (_loop && _pos != _pos_start) {
+				_rewind();
+				continue;
+			}
+			break;
+		}
+
+		if (_speed > 0 && r.t_ms > t_due) break; // not yet
+
+		if (r.type == CaptureWriter::REC_RAW) {
+			// feed as much as the room
+			int room = int(_que.capacity() - _que.size());
+			int n = r.len - _rec_done;
+			if (n > int(sizeof(_buf)) - _buf_len) n = int(sizeof(_buf)) - _buf_len;
+			if (n > room) n = room;
+			if (n <= 0) break; // full
+
+			_que.push(r.data + _rec_done, TWEUTILS::SpscQueue<uint8_t>::size_type(n));
+			memcpy(_buf + _buf_len, r.data + _rec_done, n);
+			_buf_len += n;
+			_rec_done += uint16_t(n);
+
+			if (_rec_done < r.len) break; // the rest at the next call
+		}
+
+		// the next record
+		_pos = p;
+		_rec_done = 0;
+	}
+
+	return _buf_len;
+}
+
+#endif //WIN/MAC/LINUX
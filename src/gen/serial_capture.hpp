@@ -0,0 +1,283 @@
+#pragma once
+
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+/*
+ * Capture/replay of the serial input from TWE.
+ *
+ * The capture file (all values are little endian):
+ *   HEADER   : "TWECAP" ver(u8:1) flags(u8:0) start time(u64:unix time in ms)       16 bytes
+ *   RECORD...: t_ms(u32:since start) type(u8) reserved(u8:0) len(u16) data[len]
+ *              type 1 (RAW)    : bytes received from the serial port.
+ *              type 2 (PAYLOAD): payload decoded by AsciiParser from the RAW bytes.
+ *   INDEX    : { t_ms(u32), offset of a RAW record(u32) } x count, every second.   (optional)
+ *   FOOTER   : offset of INDEX(u64) count(u32) "TIDX"                              16 bytes (optional)
+ * If the recording is broken (e.g. crashed), INDEX/FOOTER are missing and the records
+ * up to the last complete one are valid.
+ */
+
+#if defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
+
+#include "twe_common.hpp"
+#include "twe_serial.hpp"
+#include "twe_sercmd_ascii.hpp"
+#include "twe_utils_spscque.hpp"
+
+#include <cstdio>
+#include <chrono>
+#include <vector>
+
+namespace TWE {
+	/**
+	 * @class	CaptureWriter
+	 *
+	 * @brief	Records the serial input into a capture file.
+	 */
+	class CaptureWriter {
+	public:
+		static const uint8_t REC_RAW = 1;
+		static const uint8_t REC_PAYLOAD = 2;
+
+	private:
+		FILE* _fp;
+		uint64_t _offset; // the file position to write next
+		std::chrono::steady_clock::time_point _t0;
+
+		TWESERCMD::AsciiParser _parser;
+
+		// the index (one entry per second)
+		std::vector<uint32_t> _idx;
+		uint32_t _idx_next_ms;
+
+		uint32_t _now_ms() {
+			return uint32_t(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _t0).count());
+		}
+		void _write_record(uint32_t t_ms, uint8_t type, const uint8_t* p, uint16_t len);
+
+	public:
+		CaptureWriter() : _fp(nullptr), _offset(0), _t0(), _parser(512), _idx(), _idx_next_ms(0) {}
+		~CaptureWriter() { close(); }
+
+		/**
+		 * @fn	bool CaptureWriter::open(const char* path)
+		 *
+		 * @brief	Creates a capture file and starts recording.
+		 *
+		 * @param	path	The file name.
+		 *
+		 * @returns	True if it succeeds, false if it fails.
+		 */
+		bool open(const char* path);
+
+		// writes INDEX/FOOTER and closes the file.
+		void close();
+
+		inline bool is_opened() const { return _fp != nullptr; }
+
+		/**
+		 * @fn	void CaptureWriter::write(const uint8_t* p, int len)
+		 *
+		 * @brief	Records the bytes received from the serial port (a RAW record),
+		 * 			and PAYLOAD records of the sequences completed by them.
+		 *
+		 * @param	p  	The received bytes.
+		 * @param	len	The length.
+		 */
+		void write(const uint8_t* p, int len);
+	};
+
+	/**
+	 * @class	CaptureFile
+	 *
+	 * @brief	A capture file mapped on the memory (read only).
+	 */
+	class CaptureFile {
+	public:
+		static const size_t HEADER_SIZE = 16;
+		static const size_t FOOTER_SIZE = 16;
+		static const size_t RECORD_HEADER_SIZE = 8;
+
+		struct record {
+			uint32_t t_ms;
+			uint8_t type;
+			uint16_t len;
+			const uint8_t* data;
+		};
+
+	private:
+		const uint8_t* _p;
+		size_t _size;
+		size_t _rec_end; // the end of records
+		const uint8_t* _idx;
+		uint32_t _idx_count;
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+		void* _hfile;
+		void* _hmap;
+#else
+		int _fd;
+#endif
+
+	public:
+		CaptureFile();
+		~CaptureFile() { close(); }
+
+		/**
+		 * @fn	bool CaptureFile::open(const char* path)
+		 *
+		 * @brief	Maps a capture file and checks the header (and the index if exists).
+		 *
+		 * @param	path	The file name.
+		 *
+		 * @returns	True if it succeeds, false if it fails.
+		 */
+		bool open(const char* path);
+		void close();
+
+		inline bool is_opened() const { return _p != nullptr; }
+
+		// the position of the first record.
+		inline size_t begin() const { return HEADER_SIZE; }
+
+		// true if INDEX is available.
+		inline bool has_index() const { return _idx != nullptr; }
+
+		// the start time of the recording (unix time in ms).
+		uint64_t start_time() const;
+
+		/**
+		 * @fn	bool CaptureFile::next(size_t& pos, record& r) const
+		 *
+		 * @brief	Gets the record at pos, and moves pos to the next one.
+		 *
+		 * @param [in,out]	pos	The position of the record.
+		 * @param [out]   	r  	The record (data points into the mapped file).
+		 *
+		 * @returns	False if no more complete record.
+		 */
+		bool next(size_t& pos, record& r) const;
+
+		// the position of the first RAW record at or after t_ms (by INDEX if available).
+		size_t seek(uint32_t t_ms) const;
+	};
+
+	/**
+	 * @class	SerialReplay
+	 *
+	 * @brief	Serial input source from a capture file, in the same manner as SerialFtdi.
+	 * 			RAW records are fed at the recorded speed (1.0), N times faster (N),
+	 * 			or as fast as possible (0). Writing is discarded.
+	 */
+	class SerialReplay : public ISerial {
+		CaptureFile _cap;
+		size_t _pos;		// the next record
+		size_t _pos_start;	// the record to start from (also at the loop)
+		uint16_t _rec_done;	// bytes of the record at _pos already fed (partially fed)
+
+		double _speed;
+		bool _loop;
+		uint32_t _t_base;	// the record time at _t0
+		std::chrono::steady_clock::time_point _t0;
+
+		TWEUTILS::SpscQueue<uint8_t> _que;
+
+		int _buf_len;
+		char _buf[512];
+
+		char _devname[32];
+
+		void _rewind();
+		void _rebase();
+
+	public:
+		SerialReplay(size_t bufsize = 2048) : _cap(), _pos(0), _pos_start(0), _rec_done(0), _speed(1.0), _loop(false), _t_base(0), _t0()
+			, _que(TWEUTILS::SpscQueue<uint8_t>::size_type(bufsize))
+			, _buf_len(0), _buf{}, _devname{} {}
+
+		/**
+		 * @fn	bool SerialReplay::open(const char* path)
+		 *
+		 * @brief	Opens a capture file and starts replaying from the head.
+		 *
+		 * @param	path	The file name.
+		 *
+		 * @returns	True if it succeeds, false if it fails.
+		 */
+		bool open(const char* path);
+
+		void close() {
+			_cap.close();
+			_que.clear();
+			_buf_len = 0;
+			_devname[0] = 0;
+		}
+
+		bool is_opened() { return _cap.is_opened(); }
+		operator bool() { return is_opened(); }
+		const char* get_devname() { return _devname; }
+
+		// replay speed, 1.0: as recorded, N: N times faster, 0: as fast as possible.
+		void set_speed(double speed) {
+			_speed = speed < 0 ? 0 : speed;
+			_rebase(); // continue from the current record with the new speed
+		}
+
+		// replay again from the start (the head or the seek position) at the end.
+		void set_loop(bool b) { _loop = b; }
+
+		/**
+		 * @fn	bool SerialReplay::seek(uint32_t t_ms)
+		 *
+		 * @brief	Starts replaying from the first RAW record at or after t_ms.
+		 *
+		 * @param	t_ms	The time since the start of the recording.
+		 *
+		 * @returns	True if it succeeds, false if not opened.
+		 */
+		bool seek(uint32_t t_ms);
+
+		// true if all records have been fed.
+		bool is_end();
+
+		/**
+		 * @fn	int SerialReplay::update();
+		 *
+		 * @brief	feeds the records due by now into the internal queue.
+		 *
+		 * @returns	count of fed bytes (they are also seen by _get_last_buf() until the next call).
+		 */
+		int update();
+
+		int _get_last_buf(int i) {
+			if (i >= 0 && i < _buf_len) return _buf[i];
+			return -1;
+		}
+
+		int read() {
+			if (!_que.empty()) {
+				uint8_t c = _que.front();
+				_que.pop();
+				return c;
+			}
+			return -1;
+		}
+
+		bool available() { return !_que.empty(); }
+
+		// do nothing (no device)
+		int write(const uint8_t* p, int len) { return len; }
+		bool set_baudrate(int baud) { return true; }
+		void begin(uint32_t baud) {}
+		void begin(int, int, int, int) {}
+		void flush() {}
+		void setTimeout(int time_ms = 1000) {}
+		void setRxBufferSize(int i) {}
+	};
+
+	// the capture (recording) and the replay source of the serial input from TWE.
+	extern CaptureWriter the_capture;
+	extern SerialReplay the_replay;
+}
+
+#endif //WIN/MAC/LINUX
@@ -5,6 +5,12 @@
 
 #include "serial_ftdi.hpp"
 
+#include <chrono>
+#if defined(__APPLE__) || defined(__linux)
+#include <pthread.h>
+#include <sys/time.h>
+#endif
+
 using namespace TWE;
 
 // Serial Devices
@@ -27,6 +33,12 @@ bool SerialFtdi::set_baudrate(int baud) {
 extern "C" int printf_(const char* format, ...);
 
 int SerialFtdi::update() {
+	if (_reader.joinable()) {
+		// data is stored by the reader thread, just look the newly arrived data.
+		_buf_len = int(_que.peek_since(_que_echo_pos, (uint8_t*)_buf, sizeof(_buf)));
+		return _buf_len;
+	}
+
 	if (_ftHandle != NULL) {
 		DWORD rxBytes = 0, rxBytesReceived = 0;
 
@@ -37,16 +49,14 @@ int SerialFtdi::update() {
 		if (rxBytes >= sizeof(_buf)) {
 			rxBytes = sizeof(_buf);
 		}
-		if (rxBytes >= DWORD(_que.capacity() - _que.size())) {
-			rxBytes = DWORD(_que.capacity() - _que.size() - 1);
+		if (rxBytes > DWORD(_que.capacity() - _que.size())) {
+			rxBytes = DWORD(_que.capacity() - _que.size());
 		}
 
 		_ftStatus = FT_Read(_ftHandle, _buf, rxBytes, &rxBytesReceived);
 
 		if (_ftStatus == FT_OK) {
-			for (DWORD i = 0; i < rxBytesReceived; i++) {
-				_que.push(uint8_t(_buf[i]));
-			}
+			_que.push((uint8_t*)_buf, rxBytesReceived);
 
 			_buf_len = rxBytesReceived;
 			return _buf_len;
@@ -126,6 +136,8 @@ bool SerialFtdi::open(const char* devname) {
 #elif defined(__APPLE__) || defined(__linux)
 			strncpy(_devname, devname, sizeof(_devname));
 #endif
+			if (_use_reader) _start_reader();
+
 			return true;
 		}
 		else {
@@ -136,4 +148,83 @@ bool SerialFtdi::open(const char* devname) {
 	else return false;
 }
 
+void SerialFtdi::_start_reader() {
+	if (_ftHandle != NULL && !_reader.joinable()) {
+		_que_echo_pos = _que.head_pos();
+		_reader_stop.store(false);
+		_reader = std::thread(&SerialFtdi::_reader_main, this);
+	}
+}
+
+void SerialFtdi::_stop_reader() {
+	if (_reader.joinable()) {
+		_reader_stop.store(true);
+		_reader.join();
+	}
+}
+
+// the reader thread, the producer of _que.
+// waits for FT_EVENT_RXCHAR with a short timeout to check the stop request.
+void SerialFtdi::_reader_main() {
+	const int WAIT_MS = 10;
+	uint8_t buf[512];
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	HANDLE hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	FT_SetEventNotification(_ftHandle, FT_EVENT_RXCHAR, hEvent);
+#elif defined(__APPLE__) || defined(__linux)
+	EVENT_HANDLE eh;
+	pthread_mutex_init(&eh.eMutex, NULL);
+	pthread_cond_init(&eh.eCondVar, NULL);
+	FT_SetEventNotification(_ftHandle, FT_EVENT_RXCHAR, (PVOID)&eh);
+#endif
+
+	while (!_reader_stop.load()) {
+		DWORD rxBytes = 0, rxBytesReceived = 0;
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+		FT_GetQueueStatus(_ftHandle, &rxBytes);
+		if (rxBytes == 0) {
+			WaitForSingleObject(hEvent, WAIT_MS);
+			continue;
+		}
+#elif defined(__APPLE__) || defined(__linux)
+		pthread_mutex_lock(&eh.eMutex);
+		FT_GetQueueStatus(_ftHandle, &rxBytes);
+		if (rxBytes == 0) {
+			struct timeval now;
+			struct timespec ts;
+			gettimeofday(&now, NULL);
+			long nsec = now.tv_usec * 1000L + WAIT_MS * 1000000L;
+			ts.tv_sec = now.tv_sec + nsec / 1000000000L;
+			ts.tv_nsec = nsec % 1000000000L;
+			pthread_cond_timedwait(&eh.eCondVar, &eh.eMutex, &ts);
+		}
+		pthread_mutex_unlock(&eh.eMutex);
+		if (rxBytes == 0) continue;
+#endif
+
+		// limit by the room of the queue (the rest is kept in the driver's buffer)
+		DWORD room = DWORD(_que.capacity() - _que.size());
+		if (rxBytes > sizeof(buf)) rxBytes = sizeof(buf);
+		if (rxBytes > room) rxBytes = room;
+		if (rxBytes == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+
+		if (FT_Read(_ftHandle, buf, rxBytes, &rxBytesReceived) == FT_OK) {
+			_que.push(buf, rxBytesReceived);
+		}
+	}
+
+	FT_SetEventNotification(_ftHandle, 0, NULL);
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	CloseHandle(hEvent);
+#elif defined(__APPLE__) || defined(__linux)
+	pthread_cond_destroy(&eh.eCondVar);
+	pthread_mutex_destroy(&eh.eMutex);
+#endif
+}
+
 #endif //WIN/MAC
\ No newline at end of file
@@ -7,22 +7,37 @@
 
 #include "twe_common.hpp"
 #include "twe_serial.hpp"
+#include "twe_utils_spscque.hpp"
 
 #include <ftd2xx.h>
 
+#include <atomic>
+#include <thread>
+
 namespace TWE {
 	class SerialFtdi : public ISerial {
 		FT_STATUS _ftStatus;
 		FT_HANDLE _ftHandle;
 		FT_DEVICE _ftDevice;
 
-		TWEUTILS::FixedQueue<uint8_t> _que;
+		// received data (the reader thread -> the main loop, or update() -> read())
+		TWEUTILS::SpscQueue<uint8_t> _que;
+		TWEUTILS::SpscQueue<uint8_t>::size_type _que_echo_pos; // for update() under the reader thread
 
 		int _buf_len;
 		char _buf[512];
 
 		char _devname[32];
 
+		// reader thread
+		bool _use_reader;
+		std::thread _reader;
+		std::atomic<bool> _reader_stop;
+
+		void _start_reader();
+		void _stop_reader();
+		void _reader_main();
+
 	public:
 		// Serial Devices, global information
 		static ISerial::tsAryChar32 ser_devname;
@@ -44,10 +59,35 @@ namespace TWE {
 		 * @param	bufsize	(Optional) The bufsize of internal queue.
 		 */
 		SerialFtdi(size_t bufsize = 2048) : _ftStatus{}, _ftHandle{}, _ftDevice{}
-			, _que(TWEUTILS::FixedQueue<uint8_t>::size_type(bufsize))
+			, _que(TWEUTILS::SpscQueue<uint8_t>::size_type(bufsize))
+			, _que_echo_pos(0)
 			, _buf_len(0)
 			, _buf{}
-			, _devname{} {}
+			, _devname{}
+			, _use_reader(false)
+			, _reader()
+			, _reader_stop(false) {}
+
+		~SerialFtdi() {
+			_stop_reader();
+		}
+
+
+		/**
+		 * @fn	void SerialFtdi::set_reader_thread(bool b)
+		 *
+		 * @brief	Use a dedicated thread to read the device.
+		 * 			The thread waits for FT_EVENT_RXCHAR and stores received data into the internal queue,
+		 * 			so that the throughput does not depend on how often update() is called.
+		 * 			If the device is opened, the thread starts/stops immediately, otherwise at open().
+		 *
+		 * @param	b	true to use the reader thread.
+		 */
+		void set_reader_thread(bool b) {
+			_use_reader = b;
+			if (b && is_opened()) _start_reader();
+			if (!b) _stop_reader();
+		}
 
 
 		/**
@@ -102,6 +142,7 @@ namespace TWE {
 		 * @fn	int SerialFtdi::update();
 		 *
 		 * @brief	peek data from the serial driver and store data into internal queue.
+		 * 			(under the reader thread, copy newly arrived data for _get_last_buf() only.)
 		 *
 		 * @returns	An int.
 		 */
@@ -267,6 +308,8 @@ namespace TWE {
 		 * @brief	Closes the device
 		 */
 		void close() {
+			_stop_reader();
+
 			if (_ftHandle != NULL) {
 				FT_Close(_ftHandle);
 
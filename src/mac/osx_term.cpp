@@ -105,15 +105,17 @@ void TWETerm_MacConsole::refresh() {
 		}
 	}
 	
-	if (u32Dirty) {
+	scroll_as_full(); // redraw all, when scrolled.
+
+	if (dirty_lines) {
 		const int B = 256;
 		char fmt[B];
 
-		if (u32Dirty == U32DIRTY_FULL) {
+		if (dirty_lines.is_full()) {
 			wclear(stdscr);
 		}
 		for (int i = 0; i <= max_line; i++) {
-			if ((1UL << i) & u32Dirty) {
+			if (dirty_lines.test(i)) {
 				wmove(stdscr, i, 0);
 
 				int j = calc_line_index(i);
@@ -143,7 +145,7 @@ void TWETerm_MacConsole::refresh() {
 	}
 	wrefresh(stdscr);
 
-	u32Dirty = 0UL;
+	post_refresh();
 #endif
 }
 
@@ -67,10 +67,10 @@ ITerm& ITerm::write (wchar_t c) {
 				// new line
 				cursor_c = 0;
 				cursor_l = cursor_l + 1;
-				u32Dirty |= (1UL << cursor_l);
+				dirty_lines.set(cursor_l);
 				if (cursor_l > max_line) {
 					cursor_l = max_line;
-					u32Dirty |= (1UL << cursor_l);
+					dirty_lines.set(cursor_l);
 					newline();
 				}
 
@@ -84,7 +84,7 @@ ITerm& ITerm::write (wchar_t c) {
 			}
 
 			// exit here
-			u32Dirty = U32DIRTY_FULL;
+			dirty_lines.set_full();
 			wrapchar = -1;
 			return (*this);
 		}
@@ -122,7 +122,7 @@ ITerm& ITerm::write (wchar_t c) {
 				col_v = column_idx_to_vis(cursor_c, calc_line_index(cursor_l));
 				cursor_l -= val1 ? val1 : 1;
 				if (cursor_l < 0) cursor_l = 0;
-				u32Dirty |= (1UL << cursor_l);
+				dirty_lines.set(cursor_l);
 				cursor_c = column_vis_to_idx(col_v, calc_line_index(cursor_l));
 				u8OptRefresh |= U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK;
 				break;
@@ -132,7 +132,7 @@ ITerm& ITerm::write (wchar_t c) {
 				cursor_l += val1 ? val1 : 1;
 				if (cursor_l > max_line) cursor_l = max_line;
 				cursor_c = column_vis_to_idx(col_v, calc_line_index(cursor_l));
-				u32Dirty |= (1UL << cursor_l);
+				dirty_lines.set(cursor_l);
 				u8OptRefresh |= U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK;
 
 				break;
@@ -140,14 +140,14 @@ ITerm& ITerm::write (wchar_t c) {
 			case E_ESCSEQ_CURSOR_FWD:
 				cursor_c += val1 ? val1 : 1;
 				if (cursor_c > max_col) cursor_c = max_col;
-				u32Dirty |= (1UL << cursor_l);
+				dirty_lines.set(cursor_l);
 				u8OptRefresh |= U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK;
 				break;
 
 			case E_ESCSEQ_CURSOR_BWD:
 				cursor_c -= val1 ? val1 : 1;
 				if (cursor_c < 0) cursor_c = 0;
-				u32Dirty |= (1UL << cursor_l);
+				dirty_lines.set(cursor_l);
 				u8OptRefresh |= U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK;
 				break;
 
@@ -161,7 +161,7 @@ ITerm& ITerm::write (wchar_t c) {
 				if (col_v > max_col) col_v = max_col;
 				cursor_c = column_vis_to_idx(col_v, calc_line_index(cursor_l));
 
-				u32Dirty |= (1UL << cursor_l);
+				dirty_lines.set(cursor_l);
 				u8OptRefresh |= U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK;
 
 				break;
@@ -172,7 +172,7 @@ ITerm& ITerm::write (wchar_t c) {
 				if (col_v > max_col) col_v = max_col;
 				cursor_c = column_vis_to_idx(col_v, calc_line_index(cursor_l));
 
-				u32Dirty |= (1UL << cursor_l);
+				dirty_lines.set(cursor_l);
 				u8OptRefresh |= U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK;
 
 				break;
@@ -189,7 +189,7 @@ ITerm& ITerm::write (wchar_t c) {
 			case E_ESCSEQ_ERASE_LINE:
 			{
 				int i = calc_line_index(cursor_l);
-				u32Dirty |= (1UL << cursor_l);
+				dirty_lines.set(cursor_l);
 				u8OptRefresh |= U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK;
 
 				// fill with spaces
@@ -253,8 +253,8 @@ ITerm& ITerm::write (wchar_t c) {
 
 			escseq.s_init(); // init here
 		}
-		if (u32Dirty) {
-			u32Dirty |= (1UL << u8cur_init);
+		if (dirty_lines) {
+			dirty_lines.set(u8cur_init);
 		}
 		bHandled = true;
 	}
@@ -263,7 +263,7 @@ ITerm& ITerm::write (wchar_t c) {
 	if (c == '\r') {
 		// carrige return
 		cursor_c = 0;
-		u32Dirty |= (1UL) << cursor_l;
+		dirty_lines.set(cursor_l);
 		bHandled = true;
 	}
 	else if (c == 0x08) {
@@ -276,7 +276,7 @@ ITerm& ITerm::write (wchar_t c) {
 		else {
 			// ' astr_screen(i).Remove(astr_screen(i).Length - 1, 1) // remove tail char
 		}
-		u32Dirty |= (1UL) << cursor_l;
+		dirty_lines.set(cursor_l);
 		bHandled = true;
 	}
 	else if (c == 0x1B) {
@@ -287,14 +287,13 @@ ITerm& ITerm::write (wchar_t c) {
 	}
 	else if (c == '\n') {
 		cursor_c = 0;
-		u32Dirty |= (1UL) << cursor_l;
+		dirty_lines.set(cursor_l);
 		cursor_l = cursor_l + 1;
-		u32Dirty |= (1UL) << cursor_l;
+		dirty_lines.set(cursor_l);
 
 		if (cursor_l > max_line) {
 			cursor_l = max_line;
 			newline();
-			u32Dirty = U32DIRTY_FULL;
 		}
 
 		bHandled = true;
@@ -320,7 +319,7 @@ ITerm& ITerm::write (wchar_t c) {
 				// put a char at the cursor position
 				astr_screen[L][cursor_c] = GChar(c, escseq_attr);
 				cursor_c = cursor_c + 1;
-				u32Dirty |= (1UL) << cursor_l;
+				dirty_lines.set(cursor_l);
 
 				// on the right end of colomn.
 				c_vis = column_idx_to_vis(cursor_c, L);
@@ -343,6 +342,33 @@ ITerm& ITerm::write (wchar_t c) {
 	return (*this); // returns self
 }
 
+// get cells of the screen line 'l' by visual column.
+//   - cells[] shall have max_col + 1 entries.
+//   - the blank area is ' ' with escseq_attr_default.
+//   - the right half of a wide char is GChar(0, ShadowScreen::ATTR_WIDE_TAIL).
+void ITerm::get_line_cells(int l, GChar* cells) {
+	int L = calc_line_index(l);
+	unsigned len = astr_screen[L].length();
+	int v = 0;
+
+	for (unsigned j = 0; j < len && v <= max_col; j++) {
+		GChar g = astr_screen[L][j];
+
+		if (TWEUTILS::Unicode_isSingleWidth(g.chr())) {
+			cells[v++] = g;
+		}
+		else {
+			if (v + 1 > max_col) break; // no room for a wide char
+			cells[v++] = g;
+			cells[v++] = GChar(0, ShadowScreen::ATTR_WIDE_TAIL);
+		}
+	}
+
+	for (; v <= max_col; v++) {
+		cells[v] = GChar(' ', escseq_attr_default);
+	}
+}
+
 // output to stream
 void ITerm::operator >> (IStreamOut& fo) {
 
@@ -385,7 +411,7 @@ void ITerm::resize_screen(uint8_t u8c, uint8_t u8l) {
 	_init_buff();
 
 	// redraw!
-	u32Dirty = U32DIRTY_FULL;
+	dirty_lines.set_full();
 }
 
 bool TWETERM::EscSeq::operator<<(uint8_t c) {
@@ -37,8 +37,11 @@ namespace TWETERM {
 		inline operator tChar& () { return _c; }
 		inline tAttr& attr() { return _attr; }
 		inline tChar& chr() { return _c; }
+		inline tAttr attr() const { return _attr; }
+		inline tChar chr() const { return _c; }
 		GChar& operator = (tChar c) { _c = c; _attr = 0; return (*this);  }
-		bool operator == (const GChar& c) { return (_c == c._c && _attr == c._attr); }
+		bool operator == (const GChar& c) const { return (_c == c._c && _attr == c._attr); }
+		bool operator != (const GChar& c) const { return !(*this == c); }
 	};
 
 	// define matrix
@@ -148,6 +151,133 @@ namespace TWETERM {
 		}
 	};
 
+	/// <summary>
+	/// set of screen lines to be redrawn (up to 256 lines, the line index is uint8_t).
+	/// </summary>
+	class DirtyLines {
+		static const int N_WORDS = 8;
+		uint32_t _b[N_WORDS];
+		bool _full;
+
+	public:
+		DirtyLines() : _b{}, _full(false) {}
+
+		inline void set(int l) {
+			if (l >= 0 && l < N_WORDS * 32) _b[l >> 5] |= (1UL << (l & 31));
+		}
+
+		inline void set_full() { _full = true; }
+
+		inline bool is_full() const { return _full; }
+
+		inline bool test(int l) const {
+			return _full || (l >= 0 && l < N_WORDS * 32 && ((_b[l >> 5] >> (l & 31)) & 1));
+		}
+
+		inline bool any() const {
+			if (_full) return true;
+			for (auto w : _b) if (w) return true;
+			return false;
+		}
+
+		inline explicit operator bool() const { return any(); }
+
+		inline void clear() {
+			for (auto& w : _b) w = 0;
+			_full = false;
+		}
+
+		// the screen is scrolled up by n lines (line l moves to l - n).
+		void scroll_up(int n) {
+			if (n <= 0 || _full) return;
+
+			int ws = n >> 5, bs = n & 31;
+			for (int i = 0; i < N_WORDS; i++) {
+				uint32_t lo = (i + ws < N_WORDS) ? _b[i + ws] : 0;
+				uint32_t hi = (i + ws + 1 < N_WORDS) ? _b[i + ws + 1] : 0;
+				_b[i] = bs ? ((lo >> bs) | (hi << (32 - bs))) : lo;
+			}
+		}
+	};
+
+	/// <summary>
+	/// screen cells as the back end rendered last time (by visual column),
+	/// to find runs of cells to be rendered again by comparison.
+	/// </summary>
+	class ShadowScreen {
+		GChar* _buf;	// lines x cols cells, and one more line as a work area.
+		int _cols;
+		int _lines;
+
+	public:
+		static const GChar::tAttr ATTR_WIDE_TAIL = 0x4000;	// the right half of a wide char (chr is 0).
+		static const GChar::tAttr ATTR_CURSOR = 0x8000;		// rendered with the cursor.
+
+		ShadowScreen(int cols, int lines) : _buf(new GChar[cols * (lines + 1)]), _cols(cols), _lines(lines) {
+			invalidate();
+		}
+
+		~ShadowScreen() {
+			delete[] _buf;
+		}
+
+		// the cells will not match any (render all again).
+		void invalidate() {
+			for (int i = 0; i < _cols * _lines; i++) _buf[i] = GChar(0xFFFF, 0xFFFF);
+		}
+
+		inline GChar* line(int l) { return _buf + _cols * l; }
+
+		// work area of a line.
+		inline GChar* work_line() { return _buf + _cols * _lines; }
+
+		// the screen pixels were scrolled up by n lines, the exposed lines at the bottom are invalid.
+		void scroll_up(int n, int lines) {
+			if (lines > _lines) lines = _lines;
+			if (n <= 0) return;
+			if (n >= lines) { invalidate(); return; }
+
+			for (int i = 0; i < _cols * (lines - n); i++) _buf[i] = _buf[i + _cols * n];
+			for (int i = _cols * (lines - n); i < _cols * lines; i++) _buf[i] = GChar(0xFFFF, 0xFFFF);
+		}
+
+		/// <summary>
+		/// find the next run of changed cells [b, e) in the line l, starting from b.
+		///   - the run starts at the head of a wide char, and includes the tail.
+		/// </summary>
+		/// <param name="l">the line</param>
+		/// <param name="cells">new cells of the line</param>
+		/// <param name="cols">count of cells</param>
+		/// <param name="b">[in] search from, [out] start of the run</param>
+		/// <param name="e">[out] end of the run</param>
+		/// <returns>false if no more changed cells</returns>
+		bool next_run(int l, const GChar* cells, int cols, int& b, int& e) {
+			const GChar* sh = line(l);
+
+			while (b < cols && cells[b] == sh[b]) b++;
+			if (b >= cols) return false;
+			if (b > 0 && (cells[b].attr() & ATTR_WIDE_TAIL)) b--;
+
+			e = b + 1;
+			while (e < cols && (cells[e] != sh[e] || (cells[e].attr() & ATTR_WIDE_TAIL))) e++;
+			return true;
+		}
+
+		// count of cells differ from the line l.
+		int count_diff(int l, const GChar* cells, int cols) {
+			const GChar* sh = line(l);
+			int n = 0;
+			for (int i = 0; i < cols; i++) if (cells[i] != sh[i]) n++;
+			return n;
+		}
+
+		// the cells [b, e) are rendered.
+		void commit(int l, const GChar* cells, int b, int e) {
+			GChar* sh = line(l);
+			for (int i = b; i < e; i++) sh[i] = cells[i];
+		}
+	};
+
 	/// <summary>
 	/// TERMINAL class manages text buffer of the screen.
 	/// </summary>
@@ -173,8 +303,8 @@ namespace TWETERM {
 		uint8_t max_term_line;	// maximum line idx
 		uint8_t max_term_col;	// maximum column idx
 
-		uint32_t u32Dirty;		// a flag of redraw necessity.
-		const uint32_t U32DIRTY_FULL = 0xFFFFFFFF;
+		DirtyLines dirty_lines;	// lines to be redrawn.
+		int16_t scroll_lines;	// count of lines scrolled up since the last refresh (a hint for the back end).
 		uint8_t u8OptRefresh;	// if 1, hardware clear should be applied.
 
 		GChar::tAttr escseq_attr;	// attribute
@@ -207,7 +337,7 @@ namespace TWETERM {
 			u8OptRefresh(0),
 			escseq_attr(0), escseq_attr_default(0),
 
-			u32Dirty(false), cursor_l(0), cursor_c(0), end_l(u8l - 1),
+			dirty_lines(), scroll_lines(0), cursor_l(0), cursor_c(0), end_l(u8l - 1),
 			escseq(), wrapchar(-1), screen_mode(0), cursor_mode(0),
 			_utf8_stat(0), _utf8_result(0), wrap_mode(1), _bvisible(1)
 		{
@@ -226,7 +356,7 @@ namespace TWETERM {
 			u8OptRefresh(0),
 			escseq_attr(0), escseq_attr_default(0),
 
-			u32Dirty(false), cursor_l(0), cursor_c(0), end_l(u8l - 1),
+			dirty_lines(), scroll_lines(0), cursor_l(0), cursor_c(0), end_l(u8l - 1),
 			escseq(), wrapchar(-1), screen_mode(0), cursor_mode(0),
 			_utf8_stat(0), _utf8_result(0), wrap_mode(1), _bvisible(1)
 		{
@@ -263,12 +393,25 @@ namespace TWETERM {
 
 		// redraw post process (it shall be called from at the end of refresh())
 		inline void post_refresh() {
-			u32Dirty = 0;
+			dirty_lines.clear();
+			scroll_lines = 0;
 			u8OptRefresh = 0;
 		}
 		const uint8_t U8OPT_REFRESH_HARDWARE_CLEAR_MASK = 0x01;
 		const uint8_t U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK = 0x02;
 		const uint8_t U8OPT_REFRESH_WITH_SCREEN_MODE = 0x04;
+		const uint8_t U8OPT_REFRESH_REPAINT_MASK = 0x08; // the rendered screen may be broken, render all again.
+
+		// for the back end not handling scroll_lines, redraw whole screen instead.
+		inline void scroll_as_full() {
+			if (scroll_lines) {
+				dirty_lines.set_full();
+				scroll_lines = 0;
+			}
+		}
+
+		// get cells of the screen line 'l' by visual column (max_col + 1 cells).
+		void get_line_cells(int l, GChar* cells);
 
 		// new line
 		inline void newline() {
@@ -283,7 +426,10 @@ namespace TWETERM {
 			cursor_c = 0;
 			cursor_l = max_line;
 
-			u32Dirty = U32DIRTY_FULL;
+			// scrolled up by a line, the back end may move the rendered lines instead of drawing all.
+			if (scroll_lines <= max_line) scroll_lines++;
+			dirty_lines.scroll_up(1);
+			dirty_lines.set(max_line);
 		}
 
 		// calc the buffer index by screen line 'l'.
@@ -355,15 +501,15 @@ namespace TWETERM {
 			escseq_attr_default = escseq_attr; // set default when it's cleared.
 			wrapchar = -1;
 
-			u32Dirty = U32DIRTY_FULL;
+			dirty_lines.set_full();
 		}
 
 		// cursor set home pos
 		inline void home() {
-			u32Dirty |= (1UL << cursor_l);
+			dirty_lines.set(cursor_l);
 			cursor_c = 0;
 			cursor_l = 0;
-			u32Dirty |= (1UL << cursor_l);
+			dirty_lines.set(cursor_l);
 		}
 
 		// clear screen
@@ -374,13 +520,14 @@ namespace TWETERM {
 				
 		// set dirty flag to redraw screen
 		inline void force_refresh(uint8_t opt = 0) {
-			u32Dirty = U32DIRTY_FULL; 
-			u8OptRefresh = U8OPT_REFRESH_HARDWARE_CLEAR_MASK | U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK | opt;
+			dirty_lines.set_full();
+			u8OptRefresh = U8OPT_REFRESH_HARDWARE_CLEAR_MASK | U8OPT_REFRESH_WHOLE_LINE_REDRAW_MASK | U8OPT_REFRESH_REPAINT_MASK | opt;
 			refresh(); // do refresh now!
 		}
 
 		inline void refresh_text() {
-			u32Dirty = U32DIRTY_FULL;
+			dirty_lines.set_full();
+			u8OptRefresh |= U8OPT_REFRESH_REPAINT_MASK;
 		}
 
 		// add a unicode to the terminal
@@ -450,7 +597,10 @@ namespace TWETERM {
 		inline void set_wraptext(bool b) { wrap_mode = b;  }
 
 		bool visible() const { return _bvisible; }
-		bool visible(bool bvis) { return _bvisible = bvis; }
+		bool visible(bool bvis) {
+			if (bvis && !_bvisible) u8OptRefresh |= U8OPT_REFRESH_REPAINT_MASK; // may be overdrawn while hidden.
+			return _bvisible = bvis;
+		}
 
 	public:
 		TWE::IStreamOut& operator << (TWE::IStreamSpecial& sc) { return sc(*this); }
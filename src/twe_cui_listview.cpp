@@ -207,13 +207,22 @@ bool TWECUI::TWE_ListView::key_event(TWE::keyinput_type keycode) {
  * @fn	void TWECUI::TWE_ListView::sort_items(bool b_nocase)
  *
  * @brief	Sort items
+ * 			The items are unique names (e.g. file names), so the unstable sort is used.
+ * 			With b_nocase, the names equal without case are ordered by the case sensitive compare.
  *
  * @param	b_nocase	True to case insensitive.
  */
 void TWECUI::TWE_ListView::sort_items(bool b_nocase) {
+	typedef TWEUTILS::SmplBuf_WChar tItem;
+
 	if (b_nocase) {
-		TWEUTILS::SmplBufStrA_Sort2_NoCase(_list, _list_sub);
+		TWEUTILS::_SmplBuf_Sort2_Unstable(_list, _list_sub,
+			[](tItem& x, tItem& y) {
+				int c = TWEUTILS::_SmplBuf_SCompare(x, y, [](tItem::value_type z) { return toupper(z); });
+				return c ? c > 0 : TWEUTILS::_SmplBuf_SCompare(x, y) > 0;
+			});
 	} else {
-		TWEUTILS::SmplBufStrA_Sort2(_list, _list_sub);
+		TWEUTILS::_SmplBuf_Sort2_Unstable(_list, _list_sub,
+			[](tItem& x, tItem& y) { return TWEUTILS::_SmplBuf_SCompare(x, y) > 0; });
 	}
 }
\ No newline at end of file
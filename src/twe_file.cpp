@@ -18,11 +18,16 @@ namespace fs = std::filesystem;
 #include <unistd.h>
 #include <mach-o/dyld.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #elif defined(__linux)
 #include <cstdio>
 #include <unistd.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #endif
+#include <cstring>
 
 #endif
 
@@ -122,6 +127,10 @@ bool TweFile::open(TWEUTILS::SmplBuf_WChar& name) {
             close();
         }
     }
+
+    if (_b_loaded) {
+        read_chunk(0xFFFF); // read the first chunk
+    }
 #else
     try {
 #if defined(_MSC_VER) || defined(__APPLE__) || defined(__MINGW32__)
@@ -147,9 +156,22 @@ bool TweFile::open(TWEUTILS::SmplBuf_WChar& name) {
             uintmax_t n = fs::file_size(GET_FNAME_DATA());
             if (n > 0 && n <= FILE_SIZE_MAX) {
                 _size = (uint32_t)n;
-         	    _ifs.open(std::filesystem::path(GET_FNAME_DATA()), std::ios::binary);
-                
                 _b_loaded = true;
+
+                // map the whole file (read only)
+                fs::path fpath(GET_FNAME_DATA());
+#if defined(_MSC_VER) || defined(__MINGW32__)
+                _hfile = CreateFileW(fpath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+                if (_hfile != INVALID_HANDLE_VALUE) _hmap = CreateFileMappingW((HANDLE)_hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+                if (_hmap != NULL) _p_map = (const uint8_t*)MapViewOfFile((HANDLE)_hmap, FILE_MAP_READ, 0, 0, 0);
+#else
+                _fd = ::open(fpath.c_str(), O_RDONLY);
+                if (_fd >= 0) {
+                    void* p = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+                    if (p != MAP_FAILED) _p_map = (const uint8_t*)p;
+                }
+#endif
+                if (_p_map == nullptr) close();
             } else {
                 close();
             }
@@ -161,13 +183,10 @@ bool TweFile::open(TWEUTILS::SmplBuf_WChar& name) {
     }
 #endif
 
-    if (_b_loaded) {
-        read_chunk(0xFFFF); // read the first chunk
-    }
-
 	return _b_loaded;
 }
 
+#ifdef ESP32
 bool TweFile::read_chunk(uint16_t n) {
     if (_b_loaded) {
         uint32_t pos_new = n * CHUNK_SIZE;
@@ -193,7 +212,6 @@ bool TweFile::read_chunk(uint16_t n) {
         // read from the file
         _pos_chunk = n * CHUNK_SIZE;
 
-#ifdef ESP32
 		// not sure why need to open again...
 		if (_f) _f.close();
 		_f = SD.open((const char*)_fname.c_str(), FILE_READ);
@@ -202,13 +220,10 @@ bool TweFile::read_chunk(uint16_t n) {
 
 		_f.seek(_pos_chunk);
 		_f.read(_data.data(), CHUNK_SIZE);
-#else
-        _ifs.seekg(_pos_chunk);
-        _ifs.read((char*)_data.data(), CHUNK_SIZE);
-#endif
 		return true;
     } else return false;
 }
+#endif
 
 void TweFile::close() {
     if (_b_loaded) {
@@ -217,8 +232,18 @@ void TweFile::close() {
         // file close
 #ifdef ESP32
 		if (_f) _f.close();
+#elif defined(_MSC_VER) || defined(__MINGW32__)
+        if (_p_map) UnmapViewOfFile(_p_map);
+        if (_hmap != NULL) CloseHandle((HANDLE)_hmap);
+        if (_hfile != INVALID_HANDLE_VALUE) CloseHandle((HANDLE)_hfile);
+        _hmap = NULL;
+        _hfile = INVALID_HANDLE_VALUE;
+        _p_map = nullptr;
 #else
-        _ifs.close();
+        if (_p_map) munmap((void*)_p_map, _size);
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+        _p_map = nullptr;
 #endif
 
         // clean up vars
@@ -227,6 +252,14 @@ void TweFile::close() {
 }
 
 int TweFile::read(uint8_t *p, uint32_t siz) {
+#ifndef ESP32
+    // copy from the mapped file at once
+    if (!_b_loaded || _pos >= _size) return 0;
+    if (siz > _size - _pos) siz = _size - _pos;
+    memcpy(p, _p_map + _pos, siz);
+    _pos += siz;
+    return int(siz);
+#else
     uint32_t ct = 0;
 
 	int c;
@@ -241,6 +274,7 @@ int TweFile::read(uint8_t *p, uint32_t siz) {
 	}
 
     return ct;
+#endif
 }
 
 
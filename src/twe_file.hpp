@@ -286,43 +286,68 @@ namespace TWE {
 		}
 	};
 
+    /**
+     * @class	TweFile
+     *
+     * @brief	Read only file.
+     * 			ESP32 : reads the file through the CHUNK_SIZE buffer.
+     * 			others: maps the whole file on the memory, span() gives the data without copying.
+     */
     class TweFile {
+#ifdef ESP32
         static const uint32_t FILE_SIZE_MAX = 512*1024UL;
-        const uint32_t CHUNK_SIZE;
+#else
+        static const uint32_t FILE_SIZE_MAX = 0xFFFFFFFFUL;
+#endif
 
         uint32_t _size;
-        uint32_t _pos_chunk;
         uint32_t _pos;
         // TWEUTILS::SmplBuf_WChar _name;
-        TWEUTILS::SmplBuf_Byte _data;
 
         uint8_t _b_loaded;
 
 #ifdef ESP32
+        const uint32_t CHUNK_SIZE;
+        uint32_t _pos_chunk;
+        TWEUTILS::SmplBuf_Byte _data;
         File _f;
         TWEUTILS::SmplBuf_Byte _fname;
 #else
-        std::ifstream _ifs;
+        const uint8_t* _p_map; // the mapped file
+#if defined(_MSC_VER) || defined(__MINGW32__)
+        void* _hfile;
+        void* _hmap;
+#else
+        int _fd;
+#endif
 #endif
 
     public:
         TweFile(uint32_t u16_chunk_siz = 4096)
-            : CHUNK_SIZE(u16_chunk_siz)
-            , _size(0)
+            : _size(0)
             , _pos(0)
-            , _pos_chunk(0xFFFFFFFF)
             // , _name(256)
-            , _data(u16_chunk_siz)
             , _b_loaded(false)
 #ifdef ESP32
+            , CHUNK_SIZE(u16_chunk_siz)
+            , _pos_chunk(0xFFFFFFFF)
+            , _data(u16_chunk_siz)
             , _f{}
             , _fname(TWE_FILE_NAME_MAX)
 #else
-            , _ifs()
+            , _p_map(nullptr)
+#if defined(_MSC_VER) || defined(__MINGW32__)
+            , _hfile((void*)-1) // INVALID_HANDLE_VALUE
+            , _hmap(nullptr)
+#else
+            , _fd(-1)
+#endif
 #endif
         {
+#ifdef ESP32
             // set size to MAX.
             _data.resize(CHUNK_SIZE);
+#endif
         }
 
         ~TweFile() {
@@ -336,9 +361,12 @@ namespace TWE {
         void _init_vars() {
             _size = 0;
             _pos = 0;
+#ifdef ESP32
             _pos_chunk = 0xFFFFFFFF;
+#endif
         }
 
+#ifdef ESP32
         // n: chunk number
         bool read_chunk(uint16_t n);
 
@@ -363,8 +391,6 @@ namespace TWE {
             } return -1;
         }
 
-        int read(uint8_t *p, uint32_t siz);
-
         inline bool seek(uint32_t pos) {
             if (_b_loaded && pos < _size) {
                 uint16_t chunk = pos / CHUNK_SIZE;
@@ -377,6 +403,43 @@ namespace TWE {
             } else return false;
         }
 
+        // not available (no mapping)
+        inline const uint8_t* span(uint32_t pos, uint32_t len) {
+            return nullptr;
+        }
+#else
+        inline int read() {
+            if (_b_loaded && _pos < _size) {
+                return _p_map[_pos++];
+            } return -1;
+        }
+
+        inline bool seek(uint32_t pos) {
+            if (_b_loaded && pos < _size) {
+                _pos = pos;
+                return true;
+            } else return false;
+        }
+
+        /**
+         * @fn	inline const uint8_t* TweFile::span(uint32_t pos, uint32_t len)
+         *
+         * @brief	Gets the file data of [pos, pos+len) without copying.
+         *
+         * @param	pos	The position.
+         * @param	len	The length.
+         *
+         * @returns	the pointer into the mapped file (valid until close()), nullptr if out of the file.
+         */
+        inline const uint8_t* span(uint32_t pos, uint32_t len) {
+            if (_b_loaded && len <= _size && pos <= _size - len) {
+                return _p_map + pos;
+            } return nullptr;
+        }
+#endif
+
+        int read(uint8_t *p, uint32_t siz);
+
         inline uint32_t size() {
             return _size;
         }
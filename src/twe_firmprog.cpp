@@ -29,14 +29,19 @@ bool ITweBlProtocol::request_body(int8_t id_req, uint8_t id_resp) {
 
 	// prepare respbuffer
 	if (id_resp != 0) {
-		_resp_id_expected = id_resp;
-		_resp_buf.resize(0);
-		_resp_state = RESP_STAT_PROCESS;
+		wait_response(id_resp);
 	}
 
 	return true;
 }
 
+void ITweBlProtocol::wait_response(uint8_t id_resp) {
+	_tim_start = millis();
+	_resp_id_expected = id_resp;
+	_resp_buf.resize(0);
+	_resp_state = RESP_STAT_PROCESS;
+}
+
 bool ITweBlProtocol::receive(int c) {
 	if (_resp_state == RESP_STAT_PROCESS && c == -1) {
 		// timeout
@@ -83,9 +88,20 @@ bool ITweBlProtocol::receive(int c) {
 	return false;
 }
 
+/** @brief	Baud rates to try (1Mbps / div), from the highest. */
+#if defined(ESP32)
+// 1Mbps works with Serial2_IDF, however speed is not so fast, so 500kbps is good compromization.
+static const uint8_t U8_BAUD_DIV_TBL[] = { 2, 4 };
+#elif defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
+static const uint8_t U8_BAUD_DIV_TBL[] = { 1, 2, 4 };
+#endif
+static const uint8_t U8_BAUD_TRY_MAX = uint8_t(sizeof(U8_BAUD_DIV_TBL) / sizeof(U8_BAUD_DIV_TBL[0]));
+static const uint32_t U32_BAUD_RETRY_WAIT = 50; // discard input while waiting, before connecting again.
+
 /** @brief	Protocol sequence CONNECT to READ mac addr */
 const TweProg::E_ST_TWEBLP TweProg::BL_PROTOCOL_GET_MODULE_INFO[] = {
 	E_ST_TWEBLP::CONNECT,
+	E_ST_TWEBLP::VERIFY_BAUD,
 	E_ST_TWEBLP::IDENTIFY_FLASH,
 	E_ST_TWEBLP::SELECT_FLASH,
 	E_ST_TWEBLP::READ_CHIPID,
@@ -97,10 +113,48 @@ const TweProg::E_ST_TWEBLP TweProg::BL_PROTOCOL_GET_MODULE_INFO[] = {
 /** @brief	Protocol sequence ERASE and WRITE */
 const TweProg::E_ST_TWEBLP TweProg::BL_PROTOCOL_ERASE_AND_WRITE[] = {
 	E_ST_TWEBLP::CONNECT,
+	E_ST_TWEBLP::VERIFY_BAUD,
+	E_ST_TWEBLP::IDENTIFY_FLASH,
+	E_ST_TWEBLP::SELECT_FLASH,
+	E_ST_TWEBLP::ERASE_FLASH,
+	E_ST_TWEBLP::WRITE_FLASH_FROM_FILE,
+	E_ST_TWEBLP::NONE // TERRMINATE
+};
+
+/** @brief	Protocol sequence ERASE, WRITE and VERIFY (read back) */
+const TweProg::E_ST_TWEBLP TweProg::BL_PROTOCOL_ERASE_WRITE_VERIFY[] = {
+	E_ST_TWEBLP::CONNECT,
+	E_ST_TWEBLP::VERIFY_BAUD,
 	E_ST_TWEBLP::IDENTIFY_FLASH,
 	E_ST_TWEBLP::SELECT_FLASH,
 	E_ST_TWEBLP::ERASE_FLASH,
 	E_ST_TWEBLP::WRITE_FLASH_FROM_FILE,
+	E_ST_TWEBLP::VERIFY_FLASH,
+	E_ST_TWEBLP::NONE // TERRMINATE
+};
+
+/** @brief	Protocol sequence COMPARE and WRITE only different sectors */
+const TweProg::E_ST_TWEBLP TweProg::BL_PROTOCOL_DIFF_WRITE[] = {
+	E_ST_TWEBLP::CONNECT,
+	E_ST_TWEBLP::VERIFY_BAUD,
+	E_ST_TWEBLP::IDENTIFY_FLASH,
+	E_ST_TWEBLP::SELECT_FLASH,
+	E_ST_TWEBLP::COMPARE_FLASH,
+	E_ST_TWEBLP::ERASE_SECTOR,
+	E_ST_TWEBLP::WRITE_FLASH_FROM_FILE,
+	E_ST_TWEBLP::NONE // TERRMINATE
+};
+
+/** @brief	Protocol sequence COMPARE, WRITE and VERIFY only different sectors */
+const TweProg::E_ST_TWEBLP TweProg::BL_PROTOCOL_DIFF_WRITE_VERIFY[] = {
+	E_ST_TWEBLP::CONNECT,
+	E_ST_TWEBLP::VERIFY_BAUD,
+	E_ST_TWEBLP::IDENTIFY_FLASH,
+	E_ST_TWEBLP::SELECT_FLASH,
+	E_ST_TWEBLP::COMPARE_FLASH,
+	E_ST_TWEBLP::ERASE_SECTOR,
+	E_ST_TWEBLP::WRITE_FLASH_FROM_FILE,
+	E_ST_TWEBLP::VERIFY_FLASH,
 	E_ST_TWEBLP::NONE // TERRMINATE
 };
 
@@ -130,8 +184,33 @@ void TweProg::error_state() {
 }
 
 
+/**
+ * @fn	bool TweProg::_baud_fallback()
+ *
+ * @brief	After VERIFY_BAUD failed, prepares to connect again at the next lower baud rate.
+ * 			The module is set to the program mode again (at 38400bps),
+ * 			CONNECT is sent after U32_BAUD_RETRY_WAIT from process_input().
+ *
+ * @returns	True if it will retry, false if no more baud rate to try.
+ */
+bool TweProg::_baud_fallback() {
+	if (_baud_try + 1 >= U8_BAUD_TRY_MAX || _p_st_retry == nullptr) return false;
+	_baud_try++;
+
+	if (_protocol_cb) _protocol_cb(E_ST_TWEBLP::VERIFY_BAUD, EVENT_RESPOND, false, _bl->get_response_buf(), _pobj);
+
+	if (!_bl->connect()) return false;
+
+	_tim_retry = millis();
+	_b_retry = true;
+	return true;
+}
+
 bool TweProg::begin(const E_ST_TWEBLP* tbl) {
 	_p_st_table = tbl;
+	_baud_try = 0;
+	_b_retry = false;
+	_firm.b_diff = false;
 
 	if (!_bl->connect()) {
 		error_state();
@@ -152,6 +231,23 @@ bool TweProg::begin(const E_ST_TWEBLP* tbl) {
 
 bool TweProg::process_input(int c) {
 	bool bexit = false;
+
+	// waiting to connect again at a lower baud rate
+	if (_b_retry) {
+		if (c >= 0 || millis() - _tim_retry < U32_BAUD_RETRY_WAIT) return false; // discard garbage bytes
+		_b_retry = false;
+
+		_p_st_table = _p_st_retry;
+		_state = E_ST_TWEBLP::CONNECT;
+		process_body(EVENT_NEW_STATE);
+
+		if (_state == E_ST_TWEBLP::FINISH_ERROR) {
+			_u8protocol_busy = false;
+			return true;
+		}
+		return false;
+	}
+
 	bool bcomp = _bl->receive(c); // handle protocol
 
 	if (bcomp) {
@@ -171,13 +267,21 @@ bool TweProg::process_input(int c) {
 				bexit = false;
 				break;
 			default:
+				if (_state == E_ST_TWEBLP::VERIFY_BAUD && _baud_fallback()) {
+					bexit = false;
+					break;
+				}
 				error_state();
 				bexit = true;
 			}
 		} else {
-			// error
-			error_state();
-			bexit = true;
+			// error (try a lower baud rate if verifying it)
+			if (_state == E_ST_TWEBLP::VERIFY_BAUD && _baud_fallback()) {
+				bexit = false;
+			} else {
+				error_state();
+				bexit = true;
+			}
 		}
 	}
 
@@ -188,6 +292,212 @@ bool TweProg::process_input(int c) {
 	return bexit;
 }
 
+/**
+ * @fn	const uint8_t* TweProg::_firm_block(uint16_t n)
+ *
+ * @brief	Gets the data of the block n, points into the file if it's mapped (no copy),
+ * 			otherwise reads PREFETCH_BLKS blocks from the file if not in the buffer.
+ * 			The area beyond the end of file is filled with 0xFF (as erased).
+ *
+ * @param	n	The block number.
+ *
+ * @returns	the block data, nullptr if the file is not available.
+ */
+const uint8_t* TweProg::_firm_block(uint16_t n) {
+	if (!(_firm.buf_n > 0 && n >= _firm.buf_blk && n < _firm.buf_blk + _firm.buf_n)) {
+		file_type_shared file = _firm.file.lock();
+		if (_firm.file.expired()) return nullptr;
+
+		const uint8_t* p = file->span(uint32_t(n * _firm.PROTOCOL_CHUNK + 4), uint32_t(_firm.PROTOCOL_CHUNK));
+		if (p) return p;
+
+		int len = 0;
+		if (file->seek(uint32_t(n * _firm.PROTOCOL_CHUNK + 4))) {
+			len = file->read(_firm.buf, uint32_t(sizeof(_firm.buf)));
+			if (len < 0) len = 0;
+		}
+		memset(_firm.buf + len, 0xFF, sizeof(_firm.buf) - len);
+
+		_firm.buf_blk = n;
+		_firm.buf_n = uint16_t(_firm.PREFETCH_BLKS);
+	}
+
+	return _firm.buf + (n - _firm.buf_blk) * _firm.PROTOCOL_CHUNK;
+}
+
+/**
+ * @fn	bool TweProg::_firm_is_target(uint16_t n)
+ *
+ * @brief	Checks if the block n is processed in the current pass.
+ * 			WRITE_FLASH_FROM_FILE : skips blocks of all 0xFF (already erased) and,
+ * 			                        in differential mode, blocks of unchanged sectors.
+ * 			VERIFY_FLASH          : all blocks (only changed sectors in differential mode).
+ * 			COMPARE_FLASH         : all blocks.
+ *
+ * @param	n	The block number.
+ *
+ * @returns	True if it is a target.
+ */
+bool TweProg::_firm_is_target(uint16_t n) {
+	bool b_dirty = !_firm.b_diff || (_firm.dirty & (1UL << (n / _firm.SECTOR_BLKS)));
+
+	switch (_state) {
+	case E_ST_TWEBLP::WRITE_FLASH_FROM_FILE:
+		if (b_dirty) {
+			const uint8_t* p = _firm_block(n);
+			if (p == nullptr) return true; // fails at sending
+			for (size_t i = 0; i < _firm.PROTOCOL_CHUNK; i++) {
+				if (p[i] != 0xFF) return true;
+			}
+		}
+		return false;
+	case E_ST_TWEBLP::VERIFY_FLASH:
+		return b_dirty;
+	default:
+		return true;
+	}
+}
+
+/**
+ * @fn	bool TweProg::_firm_send_block(uint16_t n)
+ *
+ * @brief	Sends the request of the block n, the write request at WRITE_FLASH_FROM_FILE,
+ * 			otherwise the read request. Then reads ahead the following block from the file
+ * 			while the module is processing.
+ *
+ * @param	n	The block number.
+ *
+ * @returns	True if it succeeds, false if it fails.
+ */
+bool TweProg::_firm_send_block(uint16_t n) {
+	uint32_t u32addr = n * _firm.PROTOCOL_CHUNK;
+	bool b_ok;
+
+	if (_state == E_ST_TWEBLP::WRITE_FLASH_FROM_FILE) {
+		const uint8_t* p = _firm_block(n);
+		if (p == nullptr) return false;
+
+		b_ok = _bl->request(0x09, 0x0A
+			, uint8_t(u32addr & 0xff)
+			, uint8_t((u32addr >> 8) & 0xff)
+			, uint8_t((u32addr >> 16) & 0xff)
+			, uint8_t((u32addr >> 24) & 0xff)
+			, std::make_pair(p, size_t(_firm.PROTOCOL_CHUNK))
+			);
+	} else {
+		// read 128bytes (LSB first)
+		b_ok = _bl->request(0x0B, 0x0C
+			, uint8_t(u32addr & 0xff)
+			, uint8_t((u32addr >> 8) & 0xff)
+			, uint8_t((u32addr >> 16) & 0xff)
+			, uint8_t((u32addr >> 24) & 0xff)
+			, uint8_t(_firm.PROTOCOL_CHUNK & 0xff)
+			, uint8_t(_firm.PROTOCOL_CHUNK >> 8)
+			);
+	}
+	if (!b_ok) return false;
+
+	// read ahead (the request is already copied into the command buffer)
+	if (n + 1 < _firm.n_blk_e) {
+		if (_firm_block(n + 1) == nullptr) return false;
+	}
+
+	return true;
+}
+
+// starts a pass of the current state, counts the target blocks.
+void TweProg::_firm_pass_begin() {
+	_firm.q_head = 0;
+	_firm.q_ct = 0;
+	_firm.n_done = 0;
+	_firm.n_target = 0;
+	for (uint16_t n = 0; n < _firm.n_blk_e; n++) {
+		if (_firm_is_target(n)) _firm.n_target++;
+	}
+	_firm.n_blk_sent = 0;
+}
+
+// sends requests of the next target blocks up to the window.
+bool TweProg::_firm_pass_fill() {
+	while (_firm.q_ct < _firm.n_window) {
+		while (_firm.n_blk_sent < _firm.n_blk_e && !_firm_is_target(_firm.n_blk_sent)) _firm.n_blk_sent++;
+		if (_firm.n_blk_sent >= _firm.n_blk_e) break;
+
+		if (!_firm_send_block(_firm.n_blk_sent)) return false;
+
+		_firm.q[(_firm.q_head + _firm.q_ct) % _firm.WINDOW_MAX] = _firm.n_blk_sent;
+		_firm.q_ct++;
+		_firm.n_blk_sent++;
+	}
+	return true;
+}
+
+/**
+ * @fn	int TweProg::_firm_pass_respond()
+ *
+ * @brief	Handles a response of the pass, the read data is compared with the file
+ * 			(a mismatch is an error at VERIFY_FLASH, marks the sector at COMPARE_FLASH).
+ * 			Then sends the next requests.
+ *
+ * @returns	0:error, 1:the pass completed, 2:wait more response
+ */
+int TweProg::_firm_pass_respond() {
+	auto&& payl = _bl->get_response_buf();
+
+	// payl[0] : length (FIXED)
+	// payl[1] : RESPOND ID (FIXED)
+	// payl[2] : status (0x00: success)
+	// payl[3..] : data (read)
+	if (_firm.q_ct == 0 || payl.length() < 3 || payl[2] != 0) return 0;
+
+	uint16_t n = _firm.q[_firm.q_head];
+	_firm.q_head = (_firm.q_head + 1) % _firm.WINDOW_MAX;
+	_firm.q_ct--;
+
+	if (_state != E_ST_TWEBLP::WRITE_FLASH_FROM_FILE) {
+		const uint8_t* p = _firm_block(n);
+		if (p == nullptr || payl.length() < 3 + _firm.PROTOCOL_CHUNK) return 0;
+
+		bool b_same = true;
+		for (size_t i = 0; i < _firm.PROTOCOL_CHUNK; i++) {
+			if (payl[int(3 + i)] != p[i]) {
+				b_same = false;
+				break;
+			}
+		}
+
+		if (!b_same) {
+			if (_state == E_ST_TWEBLP::VERIFY_FLASH) return 0; // wrong data is written
+			_firm.dirty |= 1UL << (n / _firm.SECTOR_BLKS);
+		}
+	}
+
+	// progress 0..1024
+	_firm.n_done++;
+	int progress = (1024 * _firm.n_done + 512) / _firm.n_target;
+	if (_protocol_cb) _protocol_cb(_state, EVENT_RESPOND, TWE::APIRET(true, progress), payl, _pobj);
+
+	// next block requests
+	uint8_t q_ct = _firm.q_ct;
+	if (!_firm_pass_fill()) return 0;
+
+	if (_firm.q_ct == 0) return 1; // the last block
+	if (_firm.q_ct == q_ct) {
+		// no new request, wait for the rest of responses
+		_bl->wait_response(_state == E_ST_TWEBLP::WRITE_FLASH_FROM_FILE ? 0x0A : 0x0C);
+	}
+	return 2;
+}
+
+// the first dirty sector at or after from, -1 if none.
+int TweProg::_firm_next_sector(int from) {
+	int n_sect_e = (_firm.n_blk_e + _firm.SECTOR_BLKS - 1) / _firm.SECTOR_BLKS;
+	for (int i = from; i < n_sect_e && i < 32; i++) {
+		if (_firm.dirty & (1UL << i)) return i;
+	}
+	return -1;
+}
+
 /**
  * @fn	int TweProg::process_body(int c)
  *
@@ -203,19 +513,15 @@ bool TweProg::process_input(int c) {
 int TweProg::process_body(int c) {
 	APIRET ret = false;
 
-#if defined(ESP32)
-	//uint8_t U8_BAUD_DIV = 3; // The limit of Serial2 (HardwareSerial)
-	const uint8_t U8_BAUD_DIV = 2; // 1Mbps works with Serial2_IDF, however speed is not so fast, so 500kbps is good compromization.
+	const uint8_t U8_BAUD_DIV = U8_BAUD_DIV_TBL[_baud_try];
 	const uint32_t U32_BAUD = (1000000UL / U8_BAUD_DIV);
-#elif defined(_MSC_VER) || defined(__APPLE__) || defined(__linux) || defined(__MINGW32__)
-	const uint8_t U8_BAUD_DIV = 1;
-	const uint32_t U32_BAUD = (1000000UL / U8_BAUD_DIV);
-#endif
 
 	switch (_state) {
 	case E_ST_TWEBLP::CONNECT:
 		// change baud rate higher
 		if (c == EVENT_NEW_STATE) {
+			_p_st_retry = _p_st_table; // to come back here at the fallback
+
 			if (!_bl->request(0x27, 0x28, U8_BAUD_DIV)) {
 				error_state();
 				ret = false;
@@ -234,6 +540,30 @@ int TweProg::process_body(int c) {
 		}
 		break;
 
+	case E_ST_TWEBLP::VERIFY_BAUD:
+		// read back the chip ID at the new baud rate (process_input() falls back on error)
+		if (c == EVENT_NEW_STATE) {
+			if (!_bl->request(0x32, 0x33)) {
+				error_state();
+				ret = false;
+			}
+			else ret = true;
+
+			if (_protocol_cb) _protocol_cb(E_ST_TWEBLP::VERIFY_BAUD, EVENT_NEW_STATE, ret, _bl->get_command_buf(), _pobj);
+		} else
+		if (c == EVENT_RESPOND) {
+			auto&& payl = _bl->get_response_buf();
+
+			// payl[0] : length (FIXED)
+			// payl[1] : RESPOND ID (FIXED)
+			// payl[2] : Status (should be 0)
+			// payl[3..6] : Chip ID (MSB first)
+			ret = (payl.length() >= 7 && payl[2] == 0);
+
+			if (ret && _protocol_cb) _protocol_cb(E_ST_TWEBLP::VERIFY_BAUD, EVENT_RESPOND, TWE::APIRET(true, U32_BAUD), payl, _pobj);
+		}
+		break;
+
 	case E_ST_TWEBLP::IDENTIFY_FLASH:
 		// IDENTIFY_FLASH
 		if (c == EVENT_NEW_STATE) {
@@ -398,67 +728,78 @@ int TweProg::process_body(int c) {
 		break;
 
 	case E_ST_TWEBLP::WRITE_FLASH_FROM_FILE:
-		if (c == EVENT_NEW_STATE || c == EVENT_PROCEED) {
-			file_type_shared file = _firm.file.lock();
-			if (_firm.file.expired()) return false;
-
-			file->seek(_firm.n_blk * _firm.PROTOCOL_CHUNK + 4);
-			file->read(_firm.buf, _firm.PROTOCOL_CHUNK);
-
-			uint32_t u32addr = _firm.n_blk * _firm.PROTOCOL_CHUNK;
-			if (!_bl->request(0x09, 0x0A
-					, uint8_t(u32addr & 0xff)
-					, uint8_t((u32addr >> 8) & 0xff)
-					, uint8_t((u32addr >> 16) & 0xff)
-					, uint8_t((u32addr >> 24) & 0xff)
-					, std::make_pair(_firm.buf, size_t(_firm.PROTOCOL_CHUNK))
-					)
-				) {
+	case E_ST_TWEBLP::VERIFY_FLASH:
+	case E_ST_TWEBLP::COMPARE_FLASH:
+		if (c == EVENT_NEW_STATE) {
+			if (_state == E_ST_TWEBLP::COMPARE_FLASH) {
+				_firm.b_diff = true;
+				_firm.dirty = 0;
+			}
+
+			_firm_pass_begin();
+			if (_firm.n_target == 0) {
+				// nothing to do (e.g. no different sector)
+				if (_protocol_cb) _protocol_cb(_state, EVENT_NEW_STATE, true, _bl->get_command_buf(), _pobj);
+				next_state();
+				return 1;
+			}
+
+			ret = _firm_pass_fill();
+			if (!ret) error_state();
+
+			if (_protocol_cb) _protocol_cb(_state, EVENT_NEW_STATE, ret, _bl->get_command_buf(), _pobj);
+		}
+		else
+		if (c == EVENT_RESPOND) {
+			int r = _firm_pass_respond();
+			if (r == 0) error_state();
+			return r; // 2 continue
+		}
+		break;
+
+	case E_ST_TWEBLP::ERASE_SECTOR:
+		if (c == EVENT_NEW_STATE) {
+			_firm.n_sect = _firm_next_sector(0);
+			if (_firm.n_sect < 0) {
+				// no sector to erase
+				if (_protocol_cb) _protocol_cb(E_ST_TWEBLP::ERASE_SECTOR, EVENT_NEW_STATE, true, _bl->get_command_buf(), _pobj);
+				next_state();
+				return 1;
+			}
+
+			if (!_bl->request(0x0D, 0x0E, uint8_t(_firm.n_sect))) {
 				error_state();
 				ret = false;
 			}
 			else ret = true;
 
-			if (_protocol_cb && c == EVENT_NEW_STATE) // NEW STATE occurrs at only the first call.
-				_protocol_cb(E_ST_TWEBLP::WRITE_FLASH_FROM_FILE, EVENT_NEW_STATE, ret, _bl->get_command_buf(), _pobj);
-		}
-		else
+			if (_protocol_cb) _protocol_cb(E_ST_TWEBLP::ERASE_SECTOR, EVENT_NEW_STATE, ret, _bl->get_command_buf(), _pobj);
+		} else
 		if (c == EVENT_RESPOND) {
 			auto&& payl = _bl->get_response_buf();
 
-			ret = false;
-			bool berr = true;
-
-			if (payl.length() >= 3) {
-				
-				// payl[0] : length (FIXED)
-				// payl[1] : RESPOND ID (FIXED)
-				// payl[2] : status (0x00: success)
-				if (payl[2] == 0) {
-					// success
-					_firm.n_blk++;
-
-					// progress 0..1024
-					int progress = (1024 * _firm.n_blk + 512) / _firm.n_blk_e;
-					if (_protocol_cb) _protocol_cb(E_ST_TWEBLP::WRITE_FLASH_FROM_FILE, EVENT_RESPOND, TWE::APIRET(true, progress), _bl->get_response_buf(), _pobj);
-
-					if (_firm.n_blk >= _firm.n_blk_e) {
-						// the last packet
-						ret = 1;
-					} else {
-						// next block request
-						process_body(EVENT_PROCEED);
-					}
-					berr = false;
-				}
+			// payl[0] : length (FIXED)
+			// payl[1] : RESPOND ID (FIXED)
+			// payl[2] : status (0x00: success)
+			if (payl.length() < 3 || payl[2] != 0) {
+				error_state();
+				return 0;
 			}
-			if (berr) error_state();
 
+			if (_protocol_cb) _protocol_cb(E_ST_TWEBLP::ERASE_SECTOR, EVENT_RESPOND, TWE::APIRET(true, _firm.n_sect), _bl->get_response_buf(), _pobj);
 
-			if (berr) return 0;
-			else return ret ? 1 : 2; // 2 continue
-		}	
+			// the next dirty sector
+			_firm.n_sect = _firm_next_sector(_firm.n_sect + 1);
+			if (_firm.n_sect < 0) return 1;
+
+			if (!_bl->request(0x0D, 0x0E, uint8_t(_firm.n_sect))) {
+				error_state();
+				return 0;
+			}
+			return 2; // continue
+		}
 		break;
+
 	default:
 		break;
 	}
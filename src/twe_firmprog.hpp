@@ -64,6 +64,17 @@ namespace TWE {
 
 	private:
 		bool request_body(int8_t id_req, uint8_t id_resp);
+
+	public:
+		/**
+		 * @fn	void ITweBlProtocol::wait_response(uint8_t id_resp)
+		 *
+		 * @brief	Prepares to receive a response without sending a request
+		 * 			(for the next response of requests already sent).
+		 *
+		 * @param	id_resp	The expected response ID.
+		 */
+		void wait_response(uint8_t id_resp);
 	
 		template <class Cnt>
 		void _req_append(Cnt& _cnt) {
@@ -96,6 +107,19 @@ namespace TWE {
 			_req_append(_cnt, std::forward<Tail>(tail)...);
 		}
 
+		// read only data (e.g. the firmware block in the mapped file), only copied into the command buffer.
+		template <class Cnt, typename... Tail>
+		void _req_append(Cnt& _cnt, std::pair<const uint8_t *, size_t>&& ary, Tail&&... tail) {
+			const uint8_t* p = ary.first;
+			const uint8_t* e = p + ary.second;
+
+			while (p != e) {
+				_cnt.push_back(*p);
+				++p;
+			}
+			_req_append(_cnt, std::forward<Tail>(tail)...);
+		}
+
 	public:
 		bool receive(int c);
 
@@ -197,6 +221,10 @@ namespace TWE {
 			READ_MAC_CUSTOM,
 			ERASE_FLASH,
 			WRITE_FLASH_FROM_FILE,
+			VERIFY_BAUD,
+			VERIFY_FLASH,
+			COMPARE_FLASH,
+			ERASE_SECTOR,
 			FINISH = 0x81,
 			FINISH_ERROR,
 			MASK_FINISH = 0x8F
@@ -210,6 +238,15 @@ namespace TWE {
 	
 		static const E_ST_TWEBLP BL_PROTOCOL_GET_MODULE_INFO[];
 		static const E_ST_TWEBLP BL_PROTOCOL_ERASE_AND_WRITE[];
+		static const E_ST_TWEBLP BL_PROTOCOL_ERASE_WRITE_VERIFY[];
+		static const E_ST_TWEBLP BL_PROTOCOL_DIFF_WRITE[];
+		static const E_ST_TWEBLP BL_PROTOCOL_DIFF_WRITE_VERIFY[];
+
+		// the protocol sequence to write the firmware (b_diff: only different sectors, b_verify: read back).
+		static const E_ST_TWEBLP* write_protocol(bool b_diff, bool b_verify) {
+			if (b_diff) return b_verify ? BL_PROTOCOL_DIFF_WRITE_VERIFY : BL_PROTOCOL_DIFF_WRITE;
+			return b_verify ? BL_PROTOCOL_ERASE_WRITE_VERIFY : BL_PROTOCOL_ERASE_AND_WRITE;
+		}
 
 	private:
 		/* member vars */
@@ -222,6 +259,22 @@ namespace TWE {
 
 		uint8_t _u8protocol_busy;
 
+		/* baud rate negotiation */
+		uint8_t _baud_try; // index of the baud rate table (try from the highest)
+		const E_ST_TWEBLP* _p_st_retry; // the state table next to CONNECT
+		uint32_t _tim_retry; // the time of fallback
+		bool _b_retry; // waiting to connect again at a lower baud rate
+		bool _baud_fallback();
+
+		/* writing firmware */
+		const uint8_t* _firm_block(uint16_t n);
+		bool _firm_is_target(uint16_t n);
+		bool _firm_send_block(uint16_t n);
+		void _firm_pass_begin();
+		bool _firm_pass_fill();
+		int _firm_pass_respond();
+		int _firm_next_sector(int from);
+
 	private:
 		/* private member funcs */
 		void set_state(E_ST_TWEBLP s) { _state = s; }
@@ -260,22 +313,55 @@ namespace TWE {
 		 * @struct	_firm
 		 *
 		 * @brief	firmware data to be written.
+		 * 			- blocks are taken from the mapped file directly (TweFile::span()), otherwise read from
+		 * 			  the file PREFETCH_BLKS at once into buf, the next ones are read right after sending
+		 * 			  a request (while the module is writing the flash).
+		 * 			- WRITE_FLASH_FROM_FILE, VERIFY_FLASH and COMPARE_FLASH run a pass over the blocks,
+		 * 			  up to n_window requests are sent without waiting for the responses (q[]).
+		 * 			- differential mode (COMPARE_FLASH): sectors having any different block are marked
+		 * 			  in dirty, only they are erased, written and verified.
 		 */
 		struct sFirm {
 			static const size_t PROTOCOL_CHUNK = 128;
+			static const size_t PREFETCH_BLKS = 8;
+			static const uint8_t WINDOW_MAX = 4;
+			static const uint16_t SECTOR_BLKS = 32 * 1024 / PROTOCOL_CHUNK; // 32KB sector
+			static const size_t FIRM_SIZE_MAX = 512 * 1024; // the flash size
 			file_type_weak file;
-			uint8_t buf[PROTOCOL_CHUNK];
+			uint8_t buf[PROTOCOL_CHUNK * PREFETCH_BLKS];
+			uint16_t buf_blk; // the first block in buf
+			uint16_t buf_n; // count of blocks in buf (0: not loaded)
 			size_t len;
-			uint16_t n_blk;
+			uint16_t n_blk_sent; // the next block to check for the request
 			uint16_t n_blk_e;
+			uint16_t q[WINDOW_MAX]; // blocks waiting for the response (in order)
+			uint8_t q_head;
+			uint8_t q_ct;
+			uint16_t n_done; // count of processed blocks of the pass
+			uint16_t n_target; // count of blocks of the pass
+			uint8_t n_window; // max outstanding requests
+			bool b_diff; // differential mode
+			uint32_t dirty; // sectors to rewrite (differential mode)
+			int n_sect; // the sector erasing
 			uint8_t header[4];
 
 			sFirm()
 				: file()
 				, buf{}
+				, buf_blk(0)
+				, buf_n(0)
 				, len(0)
-				, n_blk(0)
+				, n_blk_sent(0)
 				, n_blk_e(0)
+				, q{}
+				, q_head(0)
+				, q_ct(0)
+				, n_done(0)
+				, n_target(0)
+				, n_window(1)
+				, b_diff(false)
+				, dirty(0)
+				, n_sect(0)
 				, header{}
 			{}
 		} _firm;
@@ -294,7 +380,8 @@ namespace TWE {
 		 * @param [in,out]	bl	The bl.
 		 */
 		TweProg(ITweBlProtocol* bl) : _bl(bl), _state(E_ST_TWEBLP::NONE), _p_st_table(nullptr)
-			, _buf_payload(32), module_info{}, _protocol_cb(nullptr), _u8protocol_busy(0), _firm{} {}
+			, _buf_payload(32), module_info{}, _protocol_cb(nullptr), _u8protocol_busy(0)
+			, _baud_try(0), _p_st_retry(nullptr), _tim_retry(0), _b_retry(false), _firm{} {}
 
 		/**
 		 * @fn	void TweProg::add_cb(PF_PROTOCOL_CB pfcb)
@@ -415,6 +502,7 @@ namespace TWE {
 			file_type_shared file = _firm.file.lock();
 			if (_firm.file.expired()) return false;
 			if (!file->is_opened()) return false;
+			if (file->size() < 4 || file->size() - 4 > _firm.FIRM_SIZE_MAX) return false;
 			
 			// header BLUE 0x04 03 00 08, RED 0F 03 00 0B
 			for (auto& x : _firm.header) {
@@ -422,7 +510,8 @@ namespace TWE {
 			}
 
 			_firm.len =file->size() - 4;
-			_firm.n_blk = 0;
+			_firm.n_blk_sent = 0;
+			_firm.buf_n = 0;
 			_firm.n_blk_e = uint16_t(_firm.len / _firm.PROTOCOL_CHUNK + 1);
 			return true;
 		}
@@ -436,7 +525,8 @@ namespace TWE {
 		 * @returns	True if it succeeds, false if it fails.
 		 */
 		bool rewind_firmware_data() {
-			_firm.n_blk = 0;
+			_firm.n_blk_sent = 0;
+			_firm.buf_n = 0; // the file may be replaced
 
 			file_type_shared file = _firm.file.lock();
 			if (_firm.file.expired()) return false;
@@ -444,6 +534,19 @@ namespace TWE {
 			return file->seek(0);
 		}
 
+		/**
+		 * @fn	void TweProg::set_write_window(uint8_t n)
+		 *
+		 * @brief	Sets the count of write/read requests sent ahead of the responses.
+		 * 			1 (default) waits for each response. The bootloader has no flow control,
+		 * 			so use 2 or more only with the module/adapter known to keep up.
+		 *
+		 * @param	n	1..sFirm::WINDOW_MAX
+		 */
+		void set_write_window(uint8_t n) {
+			_firm.n_window = n < 1 ? 1 : (n > _firm.WINDOW_MAX ? _firm.WINDOW_MAX : n);
+		}
+
 		/**
 		 * @struct	module_info
 		 *
@@ -4,16 +4,26 @@
 #include <string.h>
 #include "twe_sys.hpp"
 #include "twe_fmt.hpp"
+#include "twe_utils_pool.hpp"
 
 using namespace TWEFMT;
 using namespace TWEUTILS;
 
+// slots of the packet object pool for each packet type.
+// (if exhausted, objects are allocated from the heap.)
+#if defined(ESP32)
+static const size_t PKT_POOL_SLOTS = 40;
+#else
+static const size_t PKT_POOL_SLOTS = 512;
+#endif
+
 /// <summary>
 /// parse the PAL packet.
 /// </summary>
 /// <param name="data"></param>
+/// <param name="pidx">if given, the sensor index built by identify_packet_type() (no walk, no checksum check)</param>
 /// <returns></returns>
-E_PKT TwePacketPal::parse(uint8_t* pb, uint16_t u16len) {
+E_PKT TwePacketPal::_parse(uint8_t* pb, uint16_t u16len, const PalSnsIndex* pidx) {
 	uint8_t* p = pb;
 	uint8_t* e = pb + u16len;
 	uint8_t c = 0;
@@ -60,41 +70,33 @@ E_PKT TwePacketPal::parse(uint8_t* pb, uint16_t u16len) {
 	// save this ptr (to calculate sensor data length)
 	uint8_t* psensor = p;
 
-	// check data
-	int iStored = 0;
-	// Sensors.clear(); // clear map structure
-	for (int i = 0; i < u8sensors; i++) {
-		// check header len
-		if (e < p + 4) { break; }
-
-		// check headers
-		uint8_t u8dt = G_OCTET(p);
-		uint8_t u8ds = G_OCTET(p);
-		uint8_t u8ex = G_OCTET(p);
-		uint8_t u8ln = G_OCTET(p);
-
-		// check payload len
-		if (e < p + u8ln) { break; }
-
-		// update counters, pointers
-		iStored++;
-		p += u8ln;
-	}
-
-	if (iStored != u8sensors) {
-		// some error but accept parse sensor data.
-		u8sensors = iStored;
-		bChecksumErr = true;
+	if (pidx) {
+		// already walked and checked
+		snsidx = *pidx;
+		p = psensor + pidx->u16blklen;
 	}
 	else {
-		// perform checksum check
-		uint8_t u8crc = TWEUTILS::CRC8_u8Calc(pb, (uint8_t)(p - pb));
-		uint8_t c = G_OCTET(p);
-		if (c != u8crc) bChecksumErr = true;
+		// check data and build the sensor index (walk once)
+		int iStored = _pal_scan_sensors(psensor, e, u8sensors, p, &snsidx);
+
+		if (iStored != u8sensors) {
+			// some error but accept parse sensor data.
+			u8sensors = iStored;
+			bChecksumErr = true;
+		}
+		else if (p < e) {
+			// perform checksum check
+			uint8_t u8crc = TWEUTILS::CRC8_u8Calc(pb, (uint8_t)(p - pb));
+			if (*p != u8crc) bChecksumErr = true;
+		}
+		else {
+			// no checksum byte
+			bChecksumErr = true;
+		}
 	}
 
 	// copy data (copy serial format as is)
-	int len = int((p - 1) - psensor);
+	int len = int(p - psensor);
 	if (len <= sizeof(au8snsdata)) { // TODO
 		// copy data into pre-allocated area
 		memcpy(au8snsdata, psensor, len);
@@ -386,6 +388,50 @@ E_PKT TwePacketAppUART::parse(uint8_t* pyld, uint16_t u16len) {
 	return bValid ? E_PKT::PKT_APPUART : E_PKT::PKT_ERROR;
 }
 
+// check the fixed part of PAL packet header.
+static inline bool _is_pal_header(uint8_t* p, uint16_t u16len) {
+	return u16len > 14 // at senser data count
+		&& p[0] & 0x80 // 
+		&& p[7] & 0x80
+		&& p[12] == 0x80;
+}
+
+/**
+ * @fn	uint8_t TWEFMT::_pal_scan_sensors(uint8_t* psns, uint8_t* e, uint8_t u8ct, uint8_t*& pend, PalSnsIndex* pidx)
+ *
+ * @brief	Walk the sensor data block of PAL packet once.
+ *
+ * @param [in]	  	psns	the head of sensor data block.
+ * @param [in]	  	e   	the end of payload.
+ * @param 		  	u8ct	the count of sensors in the header.
+ * @param [out]	  	pend	the end of complete sensor entries (the checksum byte, if no error).
+ * @param [out]	  	pidx	if non-null, the index of sensor entries is built.
+ *
+ * @returns	the count of complete sensor entries.
+ */
+uint8_t TWEFMT::_pal_scan_sensors(uint8_t* psns, uint8_t* e, uint8_t u8ct, uint8_t*& pend, PalSnsIndex* pidx) {
+	uint8_t* p = psns;
+	uint8_t n = 0;
+
+	if (pidx) pidx->clear();
+
+	for (; n < u8ct; n++) {
+		// check header len
+		if (e < p + 4) break;
+
+		// check payload len
+		uint8_t u8ln = p[3];
+		if (e < p + 4 + u8ln) break;
+
+		if (pidx) pidx->set(p[1], p[2], uint16_t(p - psns));
+		p += 4 + u8ln;
+	}
+
+	pend = p;
+	if (pidx) pidx->u16blklen = uint16_t(p - psns);
+	return n;
+}
+
 /**
  * @fn	E_PKT TWEFMT::identify_packet_type(uint8_t* p, uint8_t u16len)
  *
@@ -393,44 +439,26 @@ E_PKT TwePacketAppUART::parse(uint8_t* pyld, uint16_t u16len) {
  *
  * @param [in,out]	p	 	If non-null, a pointer to payload of byte array.
  * @param 		  	u16len	the length of 'p'
+ * @param [out]	  	pidx	If non-null, the sensor index of PAL packet is stored.
  *
  * @returns	An packet id, E_PKT::PKT_ERROR in case of an error.
  */
-E_PKT TWEFMT::identify_packet_type(uint8_t* p, uint16_t u16len) {
+E_PKT TWEFMT::identify_packet_type(uint8_t* p, uint16_t u16len, PalSnsIndex* pidx) {
 	uint8_t* e = p + u16len;
 
 	bool bAccept = false;
 
 	// TWELITE PAL
-	if (!bAccept
-		&& u16len > 14 // at senser data count
-		&& p[0] & 0x80 // 
-		&& p[7] & 0x80
-		&& p[12] == 0x80
-	) {
+	if (!bAccept && _is_pal_header(p, u16len)) {
 		// check sensor data part
-		uint8_t u8ct = p[14], *ps0 = &p[15], *ps = ps0;
-		uint8_t u8Sensors = 0;
-		for (int i = 0; i < u8ct; i++) {
-			if (e > ps + 4) { // check packet len
-				uint8_t l = ps[3];
-				ps += 4; // skip header
-
-				if (e > ps + l) { // check packet len
-					u8Sensors++;
-				}
-				ps += l;
-			}
-		}
-		if (u8ct == u8Sensors) {
-			if (e > ps) {
-				// CRC
-				uint8_t u8crc = TWEUTILS::CRC8_u8Calc(p, uint8_t(ps - p));
-
-				if (u8crc == *ps) { // match CRC8
-					// accept
-					return E_PKT::PKT_PAL;
-				}
+		uint8_t u8ct = p[14], *ps = nullptr;
+		if (_pal_scan_sensors(&p[15], e, u8ct, ps, pidx) == u8ct && e > ps) {
+			// CRC
+			uint8_t u8crc = TWEUTILS::CRC8_u8Calc(p, uint8_t(ps - p));
+
+			if (u8crc == *ps) { // match CRC8
+				// accept
+				return E_PKT::PKT_PAL;
 			}
 		}
 	}
@@ -499,9 +527,15 @@ E_PKT TWEFMT::identify_packet_type(uint8_t* p, uint16_t u16len) {
 }
 
 
+// allocate a packet object with its control block in a slot of the pool dedicated for T.
+template <class T>
+inline std::shared_ptr<T> _newTwePacket_pooled() {
+	return std::allocate_shared<T>(FixedPoolAllocator<T, PKT_POOL_SLOTS>());
+}
+
 template <class T>
 inline spTwePacket _newTwePacket_parse(uint8_t* p, uint16_t u16len) {
-	auto sp = spTwePacket(new T());
+	auto sp = _newTwePacket_pooled<T>();
 	sp->parse(p, u16len);
 	return sp;
 }
@@ -519,7 +553,16 @@ inline spTwePacket _newTwePacket_parse(uint8_t* p, uint16_t u16len) {
  */
 spTwePacket TWEFMT::newTwePacket(uint8_t* p, uint16_t u16len, E_PKT eType) {
 	if (eType == E_PKT::PKT_ERROR) {
+		// PAL: identify and parse at once (walk sensor data and check CRC only once)
+		if (_is_pal_header(p, u16len)) {
+			auto sp = _newTwePacket_pooled<TwePacketPal>();
+			if (sp->parse(p, u16len) == E_PKT::PKT_PAL && !(sp->u8sensors & 0x80)) {
+				return sp;
+			}
+		}
+
 		eType = identify_packet_type(p, u16len);
+		if (eType == E_PKT::PKT_PAL) eType = E_PKT::PKT_ERROR; // already failed above
 	}
 
 	switch (eType) {
@@ -554,82 +597,85 @@ spTwePacket TWEFMT::newTwePacket(uint8_t* p, uint16_t u16len, E_PKT eType) {
  * @returns	A spTwePacketPal.
  */
 spTwePacketPal TWEFMT::newTwePacketPal(uint8_t* p, uint16_t u16len) {
-	auto pobj = std::make_shared<TwePacketPal>();
+	auto pobj = _newTwePacket_pooled<TwePacketPal>();
 	pobj->parse(p, u16len);
 	return pobj;
 }
 
+/**
+ * @fn	spTwePacketPal TWEFMT::newTwePacketPal(uint8_t* p, uint16_t u16len, const PalSnsIndex& idx)
+ *
+ * @brief	Creates a new PAL packet with the sensor index built by identify_packet_type()
+ *
+ * @param [in,out]	p	 	If non-null, an uint8_t to process.
+ * @param 		  	u16len	The length.
+ * @param 		  	idx   	The sensor index (the payload is already checked).
+ *
+ * @returns	A spTwePacketPal.
+ */
+spTwePacketPal TWEFMT::newTwePacketPal(uint8_t* p, uint16_t u16len, const PalSnsIndex& idx) {
+	auto pobj = _newTwePacket_pooled<TwePacketPal>();
+	pobj->parse(p, u16len, idx);
+	return pobj;
+}
+
 // parse function of sensors data, for operator >> (Pal???).
+// each variable is looked up with the sensor index (no walk of the sensor data block).
 // TODO: it does not have datatype check (normally, it does not have any mismatch).
-uint32_t TwePacketPal::store_data (uint8_t u8listct, void** vars, 
+static uint32_t s_pal_store_data (uint8_t* psns, const PalSnsIndex& idx, uint8_t u8listct, void** vars, 
 			const uint8_t* pu8argsize, const uint8_t* pu8argcount_max, const uint8_t* pu8dsList, const uint8_t* pu8exList) {
 	uint32_t u32store_mask = 0;
-	uint8_t* p = 0;
 
-	if (uptr_snsdata) {
-		p = uptr_snsdata.get();
-	}
-	else {
-		p = au8snsdata;
-	}
+	for (int j = 0; j < u8listct; j++) {
+		int ofs = idx.find(pu8dsList[j], pu8exList[j]);
+		if (ofs < 0) continue;
 
-	for (int i = 0; i < u8sensors; i++) {
+		uint8_t* p = psns + ofs;
 		uint8_t u8dt = G_OCTET(p);
-		uint8_t u8ds = G_OCTET(p);
-		uint8_t u8ex = G_OCTET(p);
+		p += 2; // ds, ex
 		uint8_t u8ln = G_OCTET(p);
 
-		uint8_t* pNext = p + u8ln;
-
-		for (int j = 0; j < u8listct; j++) {
-			uint32_t val = 0;
-			
-			if (u8ds == pu8dsList[j] && u8ex == pu8exList[j]) {
-				if (!(u8dt & 0x80)) {
-					uint8_t u8ty = u8dt & 0x3;
-					uint8_t typ_siz = (u8ty <= 2) ? 1 << u8ty : 1;
-
-					bool bTypeErr = false;
-
-					// type check
-					if (u8ty <= 2) {
-						if (pu8argsize[j] != typ_siz) break; // type size does not match
-						if (pu8argcount_max[j] * typ_siz < u8ln) break; // buffer length does not match
-					}
-
-					// match!
-					switch (u8dt & 0x03) {
-					case 0: case 3: // char
-						for (uint8_t k = 0; k < u8ln; k++) ((uint8_t*)vars[j])[k] = G_OCTET(p);
-						break;
-					case 1: // short 
-						for (uint8_t k = 0; k < u8ln/sizeof(uint16_t); k++) ((uint16_t*)vars[j])[k] = G_WORD(p);
-						break;
-					case 2:
-						for (uint8_t k = 0; k < u8ln/sizeof(uint32_t); k++) ((uint32_t*)vars[j])[k] = G_DWORD(p);
-						break;
-					}
-
-					u32store_mask |= (1 << j);
-					break;
-				}
-			}
+		if (u8dt & 0x80) continue;
+
+		uint8_t u8ty = u8dt & 0x3;
+		uint8_t typ_siz = (u8ty <= 2) ? 1 << u8ty : 1;
+
+		// type check
+		if (u8ty <= 2) {
+			if (pu8argsize[j] != typ_siz) continue; // type size does not match
+			if (pu8argcount_max[j] * typ_siz < u8ln) continue; // buffer length does not match
 		}
 
-		p = pNext;
+		// match!
+		switch (u8dt & 0x03) {
+		case 0: case 3: // char
+			for (uint8_t k = 0; k < u8ln; k++) ((uint8_t*)vars[j])[k] = G_OCTET(p);
+			break;
+		case 1: // short 
+			for (uint8_t k = 0; k < u8ln/sizeof(uint16_t); k++) ((uint16_t*)vars[j])[k] = G_WORD(p);
+			break;
+		case 2:
+			for (uint8_t k = 0; k < u8ln/sizeof(uint32_t); k++) ((uint32_t*)vars[j])[k] = G_DWORD(p);
+			break;
+		}
+
+		u32store_mask |= (1 << j);
 	}
 
 	return u32store_mask;
 }
 
 /**
- * @fn	uint16_t TwePacketPal::query_volt ()
+ * @fn	uint16_t TWEFMT::_pal_query_volt(uint8_t* psns, const PalSnsIndex& idx)
  *
- * @brief	Queries the module voltage
+ * @brief	Queries the module voltage from the sensor data block.
+ *
+ * @param [in]	psns	 	the head of sensor data block.
+ * @param 	  	idx 	 	the index of sensor data.
  *
  * @returns	The volt.
  */
-uint16_t TwePacketPal::query_volt () {
+uint16_t TWEFMT::_pal_query_volt(uint8_t* psns, const PalSnsIndex& idx) {
 	uint16_t u16volt = 0;
 
 	// find data
@@ -639,7 +685,7 @@ uint16_t TwePacketPal::query_volt () {
 	const uint8_t au8dsList[] = { 0x30 };
 	const uint8_t au8exList[] = { 0x08 };
 
-	uint32_t u32StoredMask = store_data(1, argList, au8argsiz, au8argctm, au8dsList, au8exList);
+	uint32_t u32StoredMask = s_pal_store_data(psns, idx, 1, argList, au8argsiz, au8argctm, au8dsList, au8exList);
 
 	return u16volt;
 }
@@ -649,7 +695,7 @@ uint16_t TwePacketPal::query_volt () {
 /// </summary>
 /// <param name="out"></param>
 /// <returns></returns>
-PalMag& TwePacketPal::operator >> (PalMag& out) {
+PalMag& TWEFMT::_pal_get(PalMag& out, E_PAL_PCB u8palpcb, uint8_t* psns, const PalSnsIndex& idx) {
 	out.u32StoredMask = 0;
 
 	if (u8palpcb != E_PAL_PCB::MAG) {
@@ -667,7 +713,7 @@ PalMag& TwePacketPal::operator >> (PalMag& out) {
 	const uint8_t au8dsList[] = { 0x30, 0x00 };
 	const uint8_t au8exList[] = { 0x08, 0x00 };
 
-	out.u32StoredMask = store_data(out.U8VARS_CT, argList, au8argsiz, au8argctm, au8dsList, au8exList);
+	out.u32StoredMask = s_pal_store_data(psns, idx, out.U8VARS_CT, argList, au8argsiz, au8argctm, au8dsList, au8exList);
 
 	out.bRegularTransmit = out.u8MagStat & 0x80 ? 1 : 0; // MSB is 
 	out.u8MagStat &= 0x7F;
@@ -680,7 +726,7 @@ PalMag& TwePacketPal::operator >> (PalMag& out) {
 /// </summary>
 /// <param name="out"></param>
 /// <returns></returns>
-PalAmb& TwePacketPal::operator >> (PalAmb& out) {
+PalAmb& TWEFMT::_pal_get(PalAmb& out, E_PAL_PCB u8palpcb, uint8_t* psns, const PalSnsIndex& idx) {
 	out.u32StoredMask = 0;
 
 	if (u8palpcb != E_PAL_PCB::AMB) {
@@ -700,17 +746,17 @@ PalAmb& TwePacketPal::operator >> (PalAmb& out) {
 	const uint8_t au8dsList[] = { 0x30, 0x01, 0x02, 0x03 };
 	const uint8_t au8exList[] = { 0x08, 0x00, 0x00, 0x00 };
 
-	out.u32StoredMask = store_data(out.U8VARS_CT, argList, au8argsiz, au8argctm, au8dsList, au8exList);
+	out.u32StoredMask = s_pal_store_data(psns, idx, out.U8VARS_CT, argList, au8argsiz, au8argctm, au8dsList, au8exList);
 
 	return out;
 }
 
 /// <summary>
-/// to PalAmb
+/// to PalMot
 /// </summary>
 /// <param name="out"></param>
 /// <returns></returns>
-PalMot& TwePacketPal::operator >> (PalMot& out) {
+PalMot& TWEFMT::_pal_get(PalMot& out, E_PAL_PCB u8palpcb, uint8_t* psns, const PalSnsIndex& idx) {
 	out.u32StoredMask = 0;
 
 	if (u8palpcb != E_PAL_PCB::MOT) {
@@ -730,7 +776,7 @@ PalMot& TwePacketPal::operator >> (PalMot& out) {
 	const uint8_t au8dsList[] = { 0x30, 4,     4,       4,       4,       4,       4,       4,       4,       4,       4,       4,        4,         4,         4,         4,         4};
 	const uint8_t au8exList[] = { 0x08, 0,     1,       2,       3,       4,       5,       6,       7,       8,       9,      10,       11,        12,        13,        14,        15};
 
-	out.u32StoredMask = store_data(out.U8VARS_CT, argList, au8argsiz, au8argctm, au8dsList, au8exList);
+	out.u32StoredMask = s_pal_store_data(psns, idx, out.U8VARS_CT, argList, au8argsiz, au8argctm, au8dsList, au8exList);
 
 	for (int i = 0; i < 16; i++) {
 		if (out.u32StoredMask & (1 << (i + 1))) {
@@ -745,4 +791,39 @@ PalMot& TwePacketPal::operator >> (PalMot& out) {
 	}
 	
 	return out;
-}
\ No newline at end of file
+}
+
+/*****************************************************
+ * PACKET VIEW
+ *****************************************************/
+
+/**
+ * @fn	spTwePacket TwePacketView::materialize() const
+ *
+ * @brief	create a packet object (allocated, parsed)
+ *
+ * @returns	A spTwePacket, empty if the view is not valid.
+ */
+spTwePacket TwePacketView::materialize() const {
+	switch (_type) {
+	case E_PKT::PKT_ERROR: return spTwePacket();
+	case E_PKT::PKT_PAL: return newTwePacketPal(_p, _len, _pal_idx); // no walk, no CRC again
+	default: return newTwePacket(_p, _len, _type);
+	}
+}
+
+/**
+ * @fn	uint16_t TwePacketView::volt() const
+ *
+ * @brief	module voltage (if the packet has the info, otherwise 0)
+ *
+ * @returns	The volt in mV.
+ */
+uint16_t TwePacketView::volt() const {
+	switch (_type) {
+	case E_PKT::PKT_PAL: return PalView(*this).query_volt();
+	case E_PKT::PKT_TWELITE: return TweliteView(*this).u16Volt();
+	case E_PKT::PKT_APPTAG: return AppTAGView(*this).u16Volt();
+	default: return 0;
+	}
+}
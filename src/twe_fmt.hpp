@@ -83,6 +83,39 @@ namespace TWEFMT {
 		ADC4 = 0x4
 	};
 
+	// index of the sensor data entries, built while walking the sensor data block once.
+	//   - a slot is assigned for each (data source, extension code) used by PalMag/Amb/Mot.
+	//   - au16ofs[] keeps (the offset of the entry header from the head of block) + 1,
+	//     0 means the entry is not present (so that zero-initialized one is empty).
+	//   - u16blklen is the length of the complete entries (the checksum byte follows).
+	struct PalSnsIndex {
+		static const uint8_t SLOTS = 21; // VOLT, HALL, TEMP, HUMD, LUMI, ACCEL x16
+		uint16_t au16ofs[SLOTS];
+		uint16_t u16blklen;
+
+		static inline int slot(uint8_t u8ds, uint8_t u8ex) {
+			switch (u8ds) {
+			case uint8_t(E_SNSCD::VOLT): return u8ex == uint8_t(E_EXCD_VOLT::POWER) ? 0 : -1;
+			case uint8_t(E_SNSCD::HALL): return u8ex == 0 ? 1 : -1;
+			case uint8_t(E_SNSCD::TEMP): return u8ex == 0 ? 2 : -1;
+			case uint8_t(E_SNSCD::HUMD): return u8ex == 0 ? 3 : -1;
+			case uint8_t(E_SNSCD::LUMI): return u8ex == 0 ? 4 : -1;
+			case uint8_t(E_SNSCD::ACCEL): return u8ex < 16 ? 5 + u8ex : -1;
+			default: return -1;
+			}
+		}
+
+		inline void clear() { for (auto& x : au16ofs) x = 0; u16blklen = 0; }
+		inline void set(uint8_t u8ds, uint8_t u8ex, uint16_t u16ofs) {
+			int i = slot(u8ds, u8ex);
+			if (i >= 0) au16ofs[i] = u16ofs + 1;
+		}
+		inline int find(uint8_t u8ds, uint8_t u8ex) const {
+			int i = slot(u8ds, u8ex);
+			return (i >= 0 && au16ofs[i]) ? au16ofs[i] - 1 : -1;
+		}
+	};
+
 	struct DataPal {
 		uint32_t u32addr_rpt;
 		uint32_t u32addr_src;
@@ -98,6 +131,8 @@ namespace TWEFMT {
 
 		uint8_t au8snsdata[32];
 		std::unique_ptr<uint8_t[]> uptr_snsdata;
+
+		PalSnsIndex snsidx;		// index of sensor data (built by parse())
 	};
 
 	struct PalBase {
@@ -132,34 +167,48 @@ namespace TWEFMT {
 		int16_t i16Z[16];
 	};
 
+	// walk the sensor data block once (returns the count of complete entries, builds the index if pidx is given).
+	uint8_t _pal_scan_sensors(uint8_t* psns, uint8_t* e, uint8_t u8ct, uint8_t*& pend, PalSnsIndex* pidx);
+
+	// extract sensor data from the sensor data block (shared by TwePacketPal and PalView).
+	uint16_t _pal_query_volt(uint8_t* psns, const PalSnsIndex& idx);
+	PalMag& _pal_get(PalMag& out, E_PAL_PCB u8palpcb, uint8_t* psns, const PalSnsIndex& idx);
+	PalAmb& _pal_get(PalAmb& out, E_PAL_PCB u8palpcb, uint8_t* psns, const PalSnsIndex& idx);
+	PalMot& _pal_get(PalMot& out, E_PAL_PCB u8palpcb, uint8_t* psns, const PalSnsIndex& idx);
+
 	class TwePacketPal : public TwePacket, public DataPal {
-		// parse each sensor data and convert into variables.
-		uint32_t store_data(uint8_t u8listct, void** vars, const uint8_t* pu8argsize, const uint8_t* pu8argcount_max, const uint8_t* pu8dsList, const uint8_t* pu8exList);
+		// sensor data block
+		inline uint8_t* _snsdata() { return uptr_snsdata ? uptr_snsdata.get() : au8snsdata; }
+		E_PKT _parse(uint8_t* p, uint16_t len, const PalSnsIndex* pidx);
 
 	public:
 		static const E_PKT _pkt_id = E_PKT::PKT_PAL;
 
 		TwePacketPal() : TwePacket(_pkt_id), DataPal({ 0 }) { }
 		~TwePacketPal() { }
-		E_PKT parse(uint8_t* p, uint16_t len);
+		E_PKT parse(uint8_t* p, uint16_t len) { return _parse(p, len, nullptr); }
+
+		// parse with the sensor index already built by identify_packet_type() (the checksum is matched),
+		// the sensor data block is neither walked nor checked again.
+		E_PKT parse(uint8_t* p, uint16_t len, const PalSnsIndex& idx) { return _parse(p, len, &idx); }
 
-		uint16_t query_volt();
+		uint16_t query_volt() { return _pal_query_volt(_snsdata(), snsidx); }
 
-		PalMag& operator >> (PalMag& out);
+		PalMag& operator >> (PalMag& out) { return _pal_get(out, u8palpcb, _snsdata(), snsidx); }
 		PalMag get_PalMag() {
 			PalMag out;
 			operator >> (out);
 			return out;
 		}
 
-		PalAmb& operator >> (PalAmb& out);
+		PalAmb& operator >> (PalAmb& out) { return _pal_get(out, u8palpcb, _snsdata(), snsidx); }
 		PalAmb get_PalAmb() {
 			PalAmb out;
 			operator >> (out);
 			return out;
 		}
 
-		PalMot& operator >> (PalMot& out);
+		PalMot& operator >> (PalMot& out) { return _pal_get(out, u8palpcb, _snsdata(), snsidx); }
 		PalMot get_PalMot() {
 			PalMot out;
 			operator >> (out);
@@ -467,7 +516,8 @@ namespace TWEFMT {
 	typedef std::shared_ptr<TwePacket> spTwePacket;
 
 	// check byte sequence and tell packet type.
-	E_PKT identify_packet_type(uint8_t* p, uint16_t len);
+	//   (for PAL, the sensor index is stored into pidx if given)
+	E_PKT identify_packet_type(uint8_t* p, uint16_t len, PalSnsIndex* pidx = nullptr);
 	static inline E_PKT identify_packet_type(TWEUTILS::SmplBuf_Byte& sbuff) {
 		return identify_packet_type(sbuff.data(), (uint16_t)sbuff.length());
 	}
@@ -524,6 +574,7 @@ namespace TWEFMT {
 	
 	// generate new PAL packet
 	spTwePacketPal newTwePacketPal(uint8_t* p, uint16_t len);
+	spTwePacketPal newTwePacketPal(uint8_t* p, uint16_t len, const PalSnsIndex& idx);
 	static inline spTwePacketPal newTwePacketPal(TWEUTILS::SmplBuf_Byte& sbuff) {
 		return newTwePacketPal(sbuff.data(), (uint16_t)sbuff.length());
 	}
@@ -549,4 +600,188 @@ namespace TWEFMT {
 	static inline TwePacketAppTAG& refTwePacketAppTAG(spTwePacket& p) {
 		return refTwePacketGen<TwePacketAppTAG>(p);
 	}
+
+	/*****************************************************
+	 * PACKET VIEW
+	 *   - non-owning view of a payload (e.g. the parser's buffer).
+	 *   - each field is read from the payload on demand,
+	 *     no allocation is performed.
+	 *   - the view is valid as long as the payload is
+	 *     unchanged (i.e. in the parser's complete context).
+	 *   - call materialize() to create TwePacket object,
+	 *     if the packet should be retained.
+	 *
+	 * e.g.)
+	 *   TwePacketView v(parse_ascii.get_payload());
+	 *   if (v.get_type() == E_PKT::PKT_PAL) {
+	 *     PalView pal(v);
+	 *     if (pal.u8palpcb() == E_PAL_PCB::AMB) {
+	 *       PalAmb amb; pal >> amb;
+	 *     }
+	 *     spTwePacket pkt = pal.materialize(); // keep it
+	 *   }
+	 *****************************************************/
+	class TwePacketView {
+	protected:
+		uint8_t* _p;
+		uint16_t _len;
+		E_PKT _type;
+		PalSnsIndex _pal_idx; // PAL: built while identifying (shared by PalView and materialize())
+
+		inline uint8_t _u8(int i) const { return _p[i]; }
+		inline uint16_t _u16(int i) const { uint8_t* p = _p + i; return TWEUTILS::G_WORD(p); }
+		inline uint32_t _u32(int i) const { uint8_t* p = _p + i; return TWEUTILS::G_DWORD(p); }
+
+	public:
+		TwePacketView() : _p(nullptr), _len(0), _type(E_PKT::PKT_ERROR), _pal_idx{} {}
+		TwePacketView(uint8_t* p, uint16_t len, E_PKT eType = E_PKT::PKT_ERROR)
+			: _p(p), _len(len), _type(eType), _pal_idx{} {
+			// PAL needs the sensor index (and the checksum check), identify it even if the type is given.
+			if (_type == E_PKT::PKT_ERROR || _type == E_PKT::PKT_PAL) _type = identify_packet_type(p, len, &_pal_idx);
+		}
+		TwePacketView(TWEUTILS::SmplBuf_Byte& sbuff, E_PKT eType = E_PKT::PKT_ERROR)
+			: TwePacketView(sbuff.data(), (uint16_t)sbuff.length(), eType) {}
+
+		inline E_PKT get_type() const { return _type; }
+		inline operator bool() const { return _type != E_PKT::PKT_ERROR; }
+		inline uint8_t* data() const { return _p; }
+		inline uint16_t length() const { return _len; }
+
+		// common information (same as TwePacket::common)
+		inline uint32_t src_addr() const {
+			switch (_type) {
+			case E_PKT::PKT_PAL: case E_PKT::PKT_APPTAG: return _u32(7);
+			case E_PKT::PKT_TWELITE: case E_PKT::PKT_APPIO: return _u32(5);
+			case E_PKT::PKT_APPUART: return _u32(3);
+			default: return 0;
+			}
+		}
+
+		inline uint8_t src_lid() const {
+			switch (_type) {
+			case E_PKT::PKT_PAL: case E_PKT::PKT_APPTAG: return _u8(11);
+			case E_PKT::PKT_TWELITE: case E_PKT::PKT_APPIO: case E_PKT::PKT_APPUART: return _u8(0);
+			default: return 0;
+			}
+		}
+
+		inline uint8_t lqi() const {
+			switch (_type) {
+			case E_PKT::PKT_PAL: case E_PKT::PKT_APPTAG: case E_PKT::PKT_TWELITE: case E_PKT::PKT_APPIO: return _u8(4);
+			case E_PKT::PKT_APPUART: return _u8(11);
+			default: return 0;
+			}
+		}
+
+		uint16_t volt() const;
+
+		// create a packet object (allocated, parsed).
+		spTwePacket materialize() const;
+	};
+
+	// view of specific packet type (the type is set as PKT_ERROR, if not matched)
+	template <class T>
+	class _TwePacketViewGen : public TwePacketView {
+	public:
+		_TwePacketViewGen(const TwePacketView& v) : TwePacketView(v) {
+			if (_type != T::_pkt_id) _type = E_PKT::PKT_ERROR;
+		}
+
+		inline std::shared_ptr<T> materialize() const {
+			return std::static_pointer_cast<T>(TwePacketView::materialize());
+		}
+	};
+
+	// PAL
+	class PalView : public _TwePacketViewGen<TwePacketPal> {
+		inline uint8_t* _snsdata() const { return _p + 15; }
+
+	public:
+		PalView(const TwePacketView& v) : _TwePacketViewGen(v) {}
+
+		inline uint32_t u32addr_rpt() const { return _u32(0); }
+		inline uint8_t u8lqi() const { return _u8(4); }
+		inline uint16_t u16seq() const { return _u16(5); }
+		inline uint32_t u32addr_src() const { return _u32(7); }
+		inline uint8_t u8addr_src() const { return _u8(11); }
+		inline E_PAL_PCB u8palpcb() const { return E_PAL_PCB(_u8(13) & 0x1F); }
+		inline uint8_t u8palpcb_rev() const {
+			uint8_t c = _u8(13) >> 5;
+			return ((c & 1) << 2) | (c & 2) | ((c & 4) >> 2);
+		}
+		inline uint8_t u8sensors() const { return _u8(14); }
+
+		inline uint16_t query_volt() const { return _pal_query_volt(_snsdata(), _pal_idx); }
+
+		inline PalMag& operator >> (PalMag& out) const { return _pal_get(out, u8palpcb(), _snsdata(), _pal_idx); }
+		inline PalAmb& operator >> (PalAmb& out) const { return _pal_get(out, u8palpcb(), _snsdata(), _pal_idx); }
+		inline PalMot& operator >> (PalMot& out) const { return _pal_get(out, u8palpcb(), _snsdata(), _pal_idx); }
+	};
+
+	// App_Twelite 0x81
+	class TweliteView : public _TwePacketViewGen<TwePacketTwelite> {
+	public:
+		TweliteView(const TwePacketView& v) : _TwePacketViewGen(v) {}
+
+		inline uint8_t u8addr_src() const { return _u8(0); }
+		inline uint8_t u8lqi() const { return _u8(4); }
+		inline uint32_t u32addr_src() const { return _u32(5); }
+		inline uint8_t u8addr_dst() const { return _u8(9); }
+		inline uint16_t u16timestamp() const { return _u16(10) & 0x7FFF; }
+		inline uint8_t b_lowlatency_tx() const { return (_u16(10) & 0x8000) ? 1 : 0; }
+		inline uint8_t u8rpt_cnt() const { return _u8(12); }
+		inline uint16_t u16Volt() const { return _u16(13); }
+		inline uint8_t DI_mask() const { return _u8(16); }
+		inline uint8_t DI_active_mask() const { return _u8(17); }
+
+		// ADC value in mV (i=0..3 for ADC1..4), 0xFFFF if not used.
+		inline uint16_t u16Adc(int i) const {
+			uint16_t v = _u8(18 + i);
+			return (v == 0xFF) ? 0xFFFF : uint16_t((v * 4 + ((_u8(22) >> (i * 2)) & 0x3)) * 4);
+		}
+	};
+
+	// App_IO 0x81
+	class AppIOView : public _TwePacketViewGen<TwePacketAppIO> {
+	public:
+		AppIOView(const TwePacketView& v) : _TwePacketViewGen(v) {}
+
+		inline uint8_t u8addr_src() const { return _u8(0); }
+		inline uint8_t u8lqi() const { return _u8(4); }
+		inline uint32_t u32addr_src() const { return _u32(5); }
+		inline uint8_t u8addr_dst() const { return _u8(9); }
+		inline uint16_t u16timestamp() const { return _u16(10) & 0x7FFF; }
+		inline uint8_t b_lowlatency_tx() const { return (_u16(10) & 0x8000) ? 1 : 0; }
+		inline uint8_t u8rpt_cnt() const { return _u8(12); }
+	};
+
+	// App_Uart (extended format)
+	class AppUARTView : public _TwePacketViewGen<TwePacketAppUART> {
+	public:
+		AppUARTView(const TwePacketView& v) : _TwePacketViewGen(v) {}
+
+		inline uint8_t u8addr_src() const { return _u8(0); }
+		inline uint8_t u8response_id() const { return _u8(2); }
+		inline uint32_t u32addr_src() const { return _u32(3); }
+		inline uint32_t u32addr_dst() const { return _u32(7); }
+		inline uint8_t u8lqi() const { return _u8(11); }
+		inline uint16_t u16paylen() const { return _u16(12); }
+		inline uint8_t* payload() const { return _p + 14; }
+	};
+
+	// App_Tag
+	class AppTAGView : public _TwePacketViewGen<TwePacketAppTAG> {
+	public:
+		AppTAGView(const TwePacketView& v) : _TwePacketViewGen(v) {}
+
+		inline uint32_t u32addr_rpt() const { return _u32(0); }
+		inline uint8_t u8lqi() const { return _u8(4); }
+		inline uint16_t u16seq() const { return _u16(5); }
+		inline uint32_t u32addr_src() const { return _u32(7); }
+		inline uint8_t u8addr_src() const { return _u8(11); }
+		inline uint8_t u8sns() const { return _u8(12); }
+		inline uint16_t u16Volt() const { return TWEUTILS::DecodeVolt(_u8(13)); }
+		inline uint16_t u16paylen() const { return _len > 14 ? _len - 14 : 0; }
+		inline uint8_t* payload() const { return _p + 14; }
+	};
 }
@@ -11,6 +11,47 @@ namespace TWEFONT {
 	const uint32_t U32_OPT_FONT_TATEBAI = 0x0100;
 	const uint32_t U32_OPT_FONT_YOKOBAI = 0x0200;
 
+	/// <summary>
+	/// two-level page table of wide chars, to find the index of font_wide_idx[] in constant time.
+	///   - generated as const data (lcd_font_*_pgtbl.src by tools/font/gen_wide_pgtbl.py).
+	///   - dir[] : high byte of the char code -> page (-1: no char in this page)
+	///   - page  : bitmap of low byte (bit set if stored) and the index of the first char of each 32bit word.
+	///   - index = base[lo >> 5] + (count of bits below lo in bits[lo >> 5])
+	/// </summary>
+	struct FontWidePageTable {
+		struct page {
+			uint32_t bits[8];
+			uint16_t base[8];
+		};
+
+		const uint16_t* font_wide_idx;	// the source table
+		int16_t dir[256];
+		const page* pages;
+
+		static inline int _popcount(uint32_t v) {
+			v = v - ((v >> 1) & 0x55555555U);
+			v = (v & 0x33333333U) + ((v >> 2) & 0x33333333U);
+			return int((((v + (v >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24);
+		}
+
+		/// <summary>
+		/// find the index of font_wide_idx[].
+		/// </summary>
+		/// <param name="c">unicode char</param>
+		/// <returns>-1: not found, 0>=: found the fond.</returns>
+		inline int find(uint16_t c) const {
+			int pg = dir[c >> 8];
+			if (pg < 0) return -1;
+
+			const page& p = pages[pg];
+			uint32_t w = p.bits[(c >> 5) & 7];
+			uint32_t b = uint32_t(1) << (c & 31);
+			if (!(w & b)) return -1;
+
+			return p.base[(c >> 5) & 7] + _popcount(w & (b - 1));
+		}
+	};
+
 	struct FontDef {
 	private:
 		/// <summary>
@@ -44,6 +85,7 @@ namespace TWEFONT {
 		const uint8_t* font_wide_missing;	// a wide char data used when missing. (use dotted box)
 		const uint16_t* font_wide_idx;		// stores supported Unicode value at the index of font_wide[]
 		uint16_t font_wide_count;			// total count of wide chars stored.
+		const FontWidePageTable* font_wide_pgtbl;	// page table of font_wide_idx[] (nullptr: use binary search)
 
 		/// <summary>
 		/// get font width with additional space(w_space)
@@ -76,7 +118,7 @@ namespace TWEFONT {
 			height(0), h_space(0),
 			data_cols(0), data_rows(0),
 			font_latin1(0), font_latin1_ex(0), font_jisx201(0),
-			font_wide(0), font_wide_missing(0), font_wide_idx(0), font_wide_count(0),
+			font_wide(0), font_wide_missing(0), font_wide_idx(0), font_wide_count(0), font_wide_pgtbl(0),
 			opt(0)
 		{
 			_default_font = b_default_font ? 1 : 0;
@@ -99,43 +141,35 @@ namespace TWEFONT {
 		inline uint8_t get_font_code() const { return font_code; }
 
 		/// <summary>
-		/// find font index data from unicode using binary search.
+		/// find font index data from unicode.
+		///   - using the page table (constant time) if it's built,
+		///   - otherwise binary search of font_wide_idx[].
 		/// </summary>
 		/// <param name="c">unicode char</param>
 		/// <returns>-1: not found, 0>=: found the fond.</returns>
 		inline int find_font_index(uint16_t c) const {
-			int b = 0;
-			int e = this->font_wide_count - 1;
-			int m = 0;
+			if (this->font_wide_pgtbl != nullptr) {
+				return this->font_wide_pgtbl->find(c);
+			}
 
 			if (this->font_wide_idx == nullptr) {
 				return -1;
 			}
 
-			while (b != e) {
-				m = (b + e) >> 1;
-				if (this->font_wide_idx[m] == c) { // bingo!
-					return m;
-				}
-				else if (e - b <= 1) {
-					if (this->font_wide_idx[e] == c) {
-						return m;
-					}
-					else {
-						// not found.
-						return -1;
-					}
+			int b = 0;
+			int e = this->font_wide_count; // search [b, e)
 
-				}
-				else if (this->font_wide_idx[m] < c) {
-					b = m;
+			while (b < e) {
+				int m = (b + e) >> 1;
+				if (this->font_wide_idx[m] < c) {
+					b = m + 1;
 				}
 				else {
 					e = m;
 				}
 			}
 
-			return -1;
+			return (b < this->font_wide_count && this->font_wide_idx[b] == c) ? b : -1;
 		}
 	};
 
@@ -6,6 +6,16 @@
 #include "twe_sercmd.hpp"
 #include "twe_sercmd_ascii.hpp"
 
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define TWESERCMD_HEXDEC_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define TWESERCMD_HEXDEC_NEON
+#endif
+
 using namespace TWE;
 using namespace TWESERCMD;
 using namespace TWESYS;
@@ -24,6 +34,111 @@ namespace TWESERCMD {
 	} teSercmdAsciiState;
 }
 
+/**
+ * @struct	_HexTable
+ *
+ * @brief	'0'-'9','A'-'F' to the nibble value, 0xFF for other chars.
+ * 			(lower case is not accepted, same as the state machine)
+ */
+struct _HexTable {
+	uint8_t v[256];
+	constexpr _HexTable() : v() {
+		for (int i = 0; i < 256; i++) {
+			v[i] = (i >= '0' && i <= '9') ? uint8_t(i - '0')
+				 : (i >= 'A' && i <= 'F') ? uint8_t(i - 'A' + 10)
+				 : 0xFF;
+		}
+	}
+};
+static constexpr _HexTable s_hextbl;
+
+/**
+ * @fn	static bool s_hex_decode_lrc(const uint8_t* src, size_t n, uint8_t* dst, uint8_t& u8sum)
+ *
+ * @brief	Decode a run of hex chars into bytes and sum them up in one pass.
+ *
+ * @param 		  	src  	hex chars (n should be even).
+ * @param 		  	n	 	the count of hex chars.
+ * @param [out]	  	dst  	decoded bytes (n/2 bytes).
+ * @param [out]	  	u8sum	the sum of decoded bytes (0 if LRC is correct).
+ *
+ * @returns	false if any of chars is not [0-9A-F].
+ */
+static bool s_hex_decode_lrc(const uint8_t* src, size_t n, uint8_t* dst, uint8_t& u8sum) {
+	uint32_t u32sum = 0;
+	size_t i = 0;
+
+#if defined(TWESERCMD_HEXDEC_SSE2)
+	const __m128i v_ofs_d = _mm_set1_epi8(char(0x80 - '0'));
+	const __m128i v_lim_d = _mm_set1_epi8(char(0x80 + 10));
+	const __m128i v_ofs_a = _mm_set1_epi8(char(0x80 - 'A'));
+	const __m128i v_lim_a = _mm_set1_epi8(char(0x80 + 6));
+	const __m128i v_0 = _mm_set1_epi8('0');
+	const __m128i v_7 = _mm_set1_epi8(7);
+	const __m128i v_lo = _mm_set1_epi16(0x00FF);
+	__m128i v_sum = _mm_setzero_si128();
+
+	for (; i + 16 <= n; i += 16) {
+		__m128i c = _mm_loadu_si128((const __m128i*)(src + i));
+
+		// range check by signed compare ('0'..'9' or 'A'..'F')
+		__m128i is_d = _mm_cmplt_epi8(_mm_add_epi8(c, v_ofs_d), v_lim_d);
+		__m128i is_a = _mm_cmplt_epi8(_mm_add_epi8(c, v_ofs_a), v_lim_a);
+		if (_mm_movemask_epi8(_mm_or_si128(is_d, is_a)) != 0xFFFF) return false;
+
+		// nibble values
+		__m128i nib = _mm_sub_epi8(_mm_sub_epi8(c, v_0), _mm_and_si128(is_a, v_7));
+
+		// combine pairs (even: upper nibble, odd: lower nibble), then pack into 8 bytes.
+		__m128i w = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nib, v_lo), 4), _mm_srli_epi16(nib, 8));
+		__m128i b = _mm_packus_epi16(w, _mm_setzero_si128());
+		_mm_storel_epi64((__m128i*)(dst + i / 2), b);
+
+		v_sum = _mm_add_epi64(v_sum, _mm_sad_epu8(b, _mm_setzero_si128()));
+	}
+	u32sum += uint32_t(_mm_cvtsi128_si32(v_sum));
+#elif defined(TWESERCMD_HEXDEC_NEON)
+	const uint8x8_t v_0 = vdup_n_u8('0');
+	const uint8x8_t v_A = vdup_n_u8('A');
+	const uint8x8_t v_10 = vdup_n_u8(10);
+	const uint8x8_t v_6 = vdup_n_u8(6);
+	const uint8x8_t v_7 = vdup_n_u8(7);
+	uint64_t u64sum = 0;
+
+	for (; i + 16 <= n; i += 16) {
+		// de-interleave (val[0]: upper nibble chars, val[1]: lower nibble chars)
+		uint8x8x2_t c = vld2_u8(src + i);
+
+		uint8x8_t d_h = vsub_u8(c.val[0], v_0), a_h = vclt_u8(vsub_u8(c.val[0], v_A), v_6);
+		uint8x8_t d_l = vsub_u8(c.val[1], v_0), a_l = vclt_u8(vsub_u8(c.val[1], v_A), v_6);
+		uint8x8_t ok = vand_u8(vorr_u8(vclt_u8(d_h, v_10), a_h), vorr_u8(vclt_u8(d_l, v_10), a_l));
+		if (vget_lane_u64(vreinterpret_u64_u8(ok), 0) != ~uint64_t(0)) return false;
+
+		uint8x8_t n_h = vsub_u8(d_h, vand_u8(a_h, v_7));
+		uint8x8_t n_l = vsub_u8(d_l, vand_u8(a_l, v_7));
+		uint8x8_t b = vorr_u8(vshl_n_u8(n_h, 4), n_l);
+		vst1_u8(dst + i / 2, b);
+
+		u64sum += vget_lane_u64(vpaddl_u32(vpaddl_u16(vpaddl_u8(b))), 0);
+	}
+	u32sum += uint32_t(u64sum);
+#endif
+
+	// the rest (or all, w/o SIMD)
+	for (; i + 1 < n; i += 2) {
+		uint8_t h = s_hextbl.v[src[i]];
+		uint8_t l = s_hextbl.v[src[i + 1]];
+		if ((h | l) & 0xF0) return false;
+
+		uint8_t c = uint8_t((h << 4) | l);
+		dst[i / 2] = c;
+		u32sum += c;
+	}
+
+	u8sum = uint8_t(u32sum);
+	return true;
+}
+
 /// <summary>
 /// ASCII形式のパース
 /// </summary>
@@ -35,6 +150,71 @@ uint8_t AsciiParser::_u8Parse(uint8_t u8byte) {
 		u8state = E_SERCMD_ASCII_CMD_EMPTY;
 	}
 
+	return _u8ParseByte(u8byte);
+}
+
+/// <summary>
+/// バイト列の解釈（系列が完結するか、入力の末尾まで）
+/// タイムアウトの確認はブロック先頭で一度だけ行う。
+/// </summary>
+/// <param name="p">入力バイト列</param>
+/// <param name="n">入力バイト列の長さ</param>
+/// <returns>消費したバイト数</returns>
+size_t AsciiParser::_parse_block(const uint8_t* p, size_t n) {
+	// check for timeout
+	if (TimeOut::is_enabled() && TimeOut::is_timeout()) {
+		u8state = E_SERCMD_ASCII_CMD_EMPTY;
+	}
+
+	size_t i = 0;
+	while (i < n) {
+		// decode hex chars at once while reading the payload (also a line continued from the last block).
+		if (u8state == E_SERCMD_ASCII_CMD_READPAYLOAD && !(u16pos & 1)) {
+			i += _parse_run(p + i, n - i);
+			if (i >= n) break;
+		}
+
+		if (_u8ParseByte(p[i++]) == E_SERCMD_ASCII_CMD_COMPLETE) break;
+	}
+
+	return i;
+}
+
+/// <summary>
+/// ペイロード読み込み中 (偶数文字目) に、続く16進文字の並びを一括で変換し、チェックサムに加える。
+/// 行がブロックをまたぐ場合も、次のブロックの先頭から続けて処理する。
+/// 奇数個目の残り、[CR]/[LF]、その他の文字は状態遷移で解釈する。
+/// </summary>
+/// <param name="p">入力バイト列</param>
+/// <param name="n">入力バイト列の長さ</param>
+/// <returns>消費したバイト数 (0:処理しなかった)</returns>
+size_t AsciiParser::_parse_run(const uint8_t* p, size_t n) {
+	size_t nchr = 0;
+	while (nchr < n && s_hextbl.v[p[nchr]] != 0xFF) nchr++;
+	nchr &= ~size_t(1);
+
+	size_t len = payload.length();
+	if (nchr == 0 || len + nchr / 2 > payload.length_max()) {
+		return 0; // overflow is handled by the state machine
+	}
+
+	payload.redim(uint16_t(len + nchr / 2));
+
+	uint8_t u8sum = 0;
+	s_hex_decode_lrc(p, nchr, payload.data() + len, u8sum); // always succeeds (checked above)
+
+	u16cksum += u8sum;
+	u16pos += uint16_t(nchr);
+
+	return nchr;
+}
+
+/// <summary>
+/// １バイトの解釈（タイムアウトの確認なし）
+/// </summary>
+/// <param name="u8byte"></param>
+/// <returns></returns>
+uint8_t AsciiParser::_u8ParseByte(uint8_t u8byte) {
 	// check for complete or error status
 	if (u8state >= 0x80) {
 		u8state = E_SERCMD_ASCII_CMD_EMPTY;
@@ -56,7 +236,7 @@ uint8_t AsciiParser::_u8Parse(uint8_t u8byte) {
 		break;
 
 	case E_SERCMD_ASCII_CMD_READPAYLOAD:
-		if ((u8byte >= '0' && u8byte <= '9') || (u8byte >= 'A' && u8byte <= 'F')) {
+		if (s_hextbl.v[u8byte] != 0xFF) {
 			/* オーバーフローのチェック */
 			//if (payload.length_max() >= (u16pos / 2) - 1) {
 			//	u8state = E_SERCMD_ASCII_CMD_ERROR;
@@ -64,8 +244,7 @@ uint8_t AsciiParser::_u8Parse(uint8_t u8byte) {
 			//}
 
 			/* 文字の16進変換 */
-			const uint8_t u8tbl[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0, 0, 0, 10, 11, 12, 13, 14, 15 };
-			uint8_t u8val = u8tbl[u8byte - '0'];
+			uint8_t u8val = s_hextbl.v[u8byte];
 
 			/* バイナリ値として格納する */
 			// int i = u16pos / 2;
@@ -18,6 +18,15 @@ namespace TWESERCMD {
 		uint16_t u16pos; //!< 入力位置（内部処理用）
 		uint16_t u16cksum; //!< チェックサム
 
+		// parse one byte w/o timeout check.
+		uint8_t _u8ParseByte(uint8_t c);
+
+		// parse a block until completion or end of block, returns consumed bytes.
+		size_t _parse_block(const uint8_t* p, size_t n);
+
+		// decode a run of hex chars of the payload at once, returns consumed bytes (0: not applicable).
+		size_t _parse_run(const uint8_t* p, size_t n);
+
 	protected:
 		inline void _vOutput(TWEUTILS::SmplBuf_Byte& bobj, TWE::IStreamOut& p) { AsciiParser::s_vOutput(bobj, p); }
 
@@ -27,6 +36,36 @@ namespace TWESERCMD {
 		~AsciiParser() {}
 		uint8_t _u8Parse(uint8_t c);
 
+		/**
+		 * @fn	template <typename TF> size_t AsciiParser::parse(const uint8_t* p, size_t n, TF on_complete)
+		 *
+		 * @brief	Parse a block of bytes (e.g. a chunk read from the serial port).
+		 * 			The state machine is run directly (w/o virtual call) and the timeout is
+		 * 			checked once per block. When a sequence is completed, on_complete(*this)
+		 * 			is called, where the payload is valid only in the callback context.
+		 *
+		 * @param	p		  	The input bytes.
+		 * @param	n		  	The length of the input bytes.
+		 * @param	on_complete	callback [](AsciiParser& parser) { ... }
+		 *
+		 * @returns	The count of completed sequences.
+		 */
+		template <typename TF>
+		size_t parse(const uint8_t* p, size_t n, TF on_complete) {
+			size_t ct = 0;
+			const uint8_t* e = p + n;
+
+			while (p < e) {
+				p += _parse_block(p, size_t(e - p));
+				if (u8state == E_TWESERCMD_COMPLETE) {
+					on_complete(*this);
+					ct++;
+				}
+			}
+
+			return ct;
+		}
+
 		/// <summary>
 		/// 再初期化
 		/// </summary>
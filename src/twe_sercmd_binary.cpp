@@ -38,6 +38,36 @@ uint8_t BinaryParser::_u8Parse(uint8_t u8byte) {
 		u8state = E_SERCMD_BINARY_EMPTY;
 	}
 
+	return _u8ParseByte(u8byte);
+}
+
+/// <summary>
+/// バイト列の解釈（系列が完結するか、入力の末尾まで）
+/// タイムアウトの確認はブロック先頭で一度だけ行う。
+/// </summary>
+/// <param name="p">入力バイト列</param>
+/// <param name="n">入力バイト列の長さ</param>
+/// <returns>消費したバイト数</returns>
+size_t BinaryParser::_parse_block(const uint8_t* p, size_t n) {
+	// check for timeout
+	if (TimeOut::is_enabled() && TimeOut::is_timeout()) {
+		u8state = E_SERCMD_BINARY_EMPTY;
+	}
+
+	size_t i = 0;
+	while (i < n) {
+		if (_u8ParseByte(p[i++]) == E_SERCMD_BINARY_COMPLETE) break;
+	}
+
+	return i;
+}
+
+/// <summary>
+/// １バイトの解釈（タイムアウトの確認なし）
+/// </summary>
+/// <param name="u8byte"></param>
+/// <returns></returns>
+uint8_t BinaryParser::_u8ParseByte(uint8_t u8byte) {
 	// check for complete or error status
 	if (u8state >= 0x80) {
 		u8state = E_SERCMD_BINARY_EMPTY;
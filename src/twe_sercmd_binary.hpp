@@ -18,7 +18,13 @@ namespace TWESERCMD {
 	private:
 		uint16_t u16pos; //!< 入力位置（内部処理用）
 		uint16_t  u16cksum; //!< チェックサム
-		
+
+		// parse one byte w/o timeout check.
+		uint8_t _u8ParseByte(uint8_t u8byte);
+
+		// parse a block until completion or end of block, returns consumed bytes.
+		size_t _parse_block(const uint8_t* p, size_t n);
+
 	protected:
 		static const uint8_t SERCMD_SYNC_1 = 0xA5;
 		static const uint8_t SERCMD_SYNC_2 = 0x5A;
@@ -29,6 +35,36 @@ namespace TWESERCMD {
 	public:
 		BinaryParser(TWEUTILS::SmplBuf_Byte& bobj) : IParser(bobj), u16pos(0), u16cksum(0) {  }
 		~BinaryParser() {}
+
+		/**
+		 * @fn	template <typename TF> size_t BinaryParser::parse(const uint8_t* p, size_t n, TF on_complete)
+		 *
+		 * @brief	Parse a block of bytes (e.g. a chunk read from the serial port).
+		 * 			The state machine is run directly (w/o virtual call) and the timeout is
+		 * 			checked once per block. When a sequence is completed, on_complete(*this)
+		 * 			is called, where the payload is valid only in the callback context.
+		 *
+		 * @param	p		  	The input bytes.
+		 * @param	n		  	The length of the input bytes.
+		 * @param	on_complete	callback [](BinaryParser& parser) { ... }
+		 *
+		 * @returns	The count of completed sequences.
+		 */
+		template <typename TF>
+		size_t parse(const uint8_t* p, size_t n, TF on_complete) {
+			size_t ct = 0;
+			const uint8_t* e = p + n;
+
+			while (p < e) {
+				p += _parse_block(p, size_t(e - p));
+				if (u8state == E_TWESERCMD_COMPLETE) {
+					on_complete(*this);
+					ct++;
+				}
+			}
+
+			return ct;
+		}
 		
 		/// <summary>
 		/// 再初期化
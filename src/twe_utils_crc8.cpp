@@ -12,15 +12,18 @@
   * Made modification as below:
   * - change names (vars/funcs)
   * - add TWE_XOR_u8Calc(), TWE_CRC8_u8CalcU32()
+  * - size_t length, slice-by-4 CRC8 (except ESP32), word-at-a-time XOR/LRC
   */
 
 #include "twe_common.hpp"
 #include "twe_utils.hpp"
 #include "twe_utils_crc8.hpp"
 
+#include <cstring>
+
 
 namespace TWEUTILS {
-	static const uint8_t u8CRCTable[256] =
+	static constexpr uint8_t u8CRCTable[256] =
 	{
 		0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
 		0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
@@ -56,38 +59,79 @@ namespace TWEUTILS {
 		0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC
 	};
 
+#if !defined(ESP32)
+	/*!
+	 * slice-by-4 用のテーブル
+	 *   u8CRCTable4[k][x] は x に続けて k バイトの 0 を処理した CRC8 値
+	 *   (u8CRCTable4[0] は u8CRCTable と同じ)
+	 */
+	struct _CRC8Table4 {
+		uint8_t t[4][256];
+
+		constexpr _CRC8Table4() : t{} {
+			for (int x = 0; x < 256; x++) {
+				t[0][x] = u8CRCTable[x];
+				for (int k = 1; k < 4; k++) t[k][x] = u8CRCTable[t[k - 1][x]];
+			}
+		}
+	};
+	static constexpr _CRC8Table4 u8CRCTable4;
+#endif
+
+	// load 32/64bit word from unaligned pointer
+	static inline uint32_t _load_u32(const uint8_t* p) { uint32_t w; memcpy(&w, p, sizeof(w)); return w; }
+	static inline uint64_t _load_u64(const uint8_t* p) { uint64_t w; memcpy(&w, p, sizeof(w)); return w; }
+
 	/*!
 	 * バイト列からCRC8を計算する
+	 *   ESP32 以外では 4バイト単位で処理する (slice-by-4)。
 	 *
 	 * \param pu8Data バイト列
 	 * \param size    サイズ
 	 * \return        計算されたCRC8値
 	 */
-	uint8_t CRC8_u8Calc(uint8_t* pu8Data, uint8_t size)
+	uint8_t CRC8_u8Calc(uint8_t* pu8Data, size_t size)
 	{
-		uint32_t i;
 		uint8_t u8crc = 0;
+		const uint8_t* p = pu8Data;
+		const uint8_t* e = pu8Data + size;
 
-		for (i = 0; i < size; i++)
+#if !defined(ESP32)
+		const auto& t = u8CRCTable4.t;
+		for (; e - p >= 4; p += 4) {
+			u8crc = t[3][u8crc ^ p[0]] ^ t[2][p[1]] ^ t[1][p[2]] ^ t[0][p[3]];
+		}
+#endif
+		for (; p < e; p++)
 		{
-			u8crc = u8CRCTable[(u8crc ^ pu8Data[i]) & 0xFF];
+			u8crc = u8CRCTable[u8crc ^ *p];
 		}
 		return u8crc;
 	}
 
 	/*!
 	 * バイト列からXORを計算する
+	 *   8バイト単位で XOR してから畳み込む。
 	 *
 	 * \param pu8Data バイト列
 	 * \param size    サイズ
 	 * \return        計算されたXOR値
 	 */
-	uint8_t XOR_u8Calc(uint8_t* pu8Data, uint8_t size) {
-		uint32_t i;
-		uint8_t u8xor = 0;
+	uint8_t XOR_u8Calc(uint8_t* pu8Data, size_t size) {
+		const uint8_t* p = pu8Data;
+		const uint8_t* e = pu8Data + size;
+		uint64_t w = 0;
+
+		for (; e - p >= 8; p += 8) {
+			w ^= _load_u64(p);
+		}
+		w ^= w >> 32;
+		w ^= w >> 16;
+		w ^= w >> 8;
 
-		for (i = 0; i < size; i++) {
-			u8xor ^= pu8Data[i];
+		uint8_t u8xor = uint8_t(w);
+		for (; p < e; p++) {
+			u8xor ^= *p;
 		}
 
 		return u8xor;
@@ -95,17 +139,26 @@ namespace TWEUTILS {
 
 	/*!
 	 * バイト列からLRCを計算する
+	 *   4バイト単位で 16bit の2レーンに加算する (各レーンは下位8bitのみ保持)。
 	 *
 	 * \param pu8Data バイト列
 	 * \param size    サイズ
 	 * \return        計算されたXOR値
 	 */
-	uint8_t LRC_u8Calc(uint8_t* pu8Data, uint8_t size) {
-		uint32_t i;
-		uint8_t u8lrc = 0;
+	uint8_t LRC_u8Calc(uint8_t* pu8Data, size_t size) {
+		const uint8_t* p = pu8Data;
+		const uint8_t* e = pu8Data + size;
+		const uint32_t M = 0x00FF00FF;
+		uint32_t w = 0;
+
+		for (; e - p >= 4; p += 4) {
+			uint32_t v = _load_u32(p);
+			w = (w + (v & M) + ((v >> 8) & M)) & M;
+		}
 
-		for (i = 0; i < size; i++) {
-			u8lrc += pu8Data[i];
+		uint8_t u8lrc = uint8_t(w + (w >> 16));
+		for (; p < e; p++) {
+			u8lrc += *p;
 		}
 
 		return (~u8lrc + 1);
@@ -6,11 +6,14 @@
  * CRC.cs
  * **********************************/
 #include "twe_common.hpp"
+#include <stddef.h>
 
 namespace TWEUTILS {
-	uint8_t CRC8_u8Calc(uint8_t *pu8Data, uint8_t size);
+	// note: size is size_t, inputs over 255 bytes are not truncated.
+	//       (to keep the former behavior, cast the length to uint8_t at caller.)
+	uint8_t CRC8_u8Calc(uint8_t *pu8Data, size_t size);
 	uint8_t CRC8_u8CalcU32(uint32_t u32c);
-	uint8_t XOR_u8Calc(uint8_t *pu8Data, uint8_t size);
-	uint8_t LRC_u8Calc(uint8_t* pu8Data, uint8_t size);
+	uint8_t XOR_u8Calc(uint8_t *pu8Data, size_t size);
+	uint8_t LRC_u8Calc(uint8_t* pu8Data, size_t size);
 }
 
@@ -150,6 +150,30 @@ namespace TWEUTILS {
 			return std::move(x);
 		}
 
+		/**
+		 * @fn	inline size_type FixedQueue::pop_front(T* p, size_type n)
+		 *
+		 * @brief	Pops up to n entries from the front into the array p.
+		 *
+		 * @param [out]	p	the destination array.
+		 * @param 	   	n	the max count of entries to pop.
+		 *
+		 * @returns	count of popped entries.
+		 */
+		inline size_type pop_front(T* p, size_type n) {
+			size_type ct = (n < _ct) ? n : _ct;
+
+			for (size_type i = 0; i < ct; i++) {
+				p[i] = std::move(_p[_tail]);
+				if (++_tail >= _size) {
+					_tail = 0;
+				}
+			}
+			_ct -= ct;
+
+			return ct;
+		}
+
 	};
 
 	template <typename T>
@@ -188,6 +212,11 @@ namespace TWEUTILS {
 			}
 		}
 
+		// push n entries (the oldest ones are removed if overrun).
+		inline void push(const T* p, int n) {
+			for (int i = 0; i < n; i++) push(p[i]);
+		}
+
 		/**
 		 * @fn	inline bool InputQueue::is_full()
 		 *
@@ -222,6 +251,21 @@ namespace TWEUTILS {
 		inline int read() {
 			return pop_front();
 		}
+
+		/**
+		 * @fn	inline int InputQueue::read(T* p, int n)
+		 *
+		 * @brief	Read a block of data from queue.
+		 *
+		 * @param [out]	p	the destination array.
+		 * @param 	   	n	the size of the destination array.
+		 *
+		 * @returns	count of read entries, 0: no data.
+		 */
+		inline int read(T* p, int n) {
+			if (!_cue || n <= 0) return 0;
+			return _cue->pop_front(p, typename TWEUTILS::FixedQueue<T>::size_type(n));
+		}
 	};
 
 } // TWEUTILS
@@ -0,0 +1,112 @@
+#pragma once
+
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+#include "twe_common.hpp"
+
+#include <memory>
+
+namespace TWEUTILS {
+	/**
+	 * @class	HashIndex
+	 *
+	 * @brief	An open addressing hash table (linear probing) from a 32bit key to an index
+	 * 			of a dense array (e.g. the serial ID of a node -> the entry of SimpleBuffer<>).
+	 * 			- the table grows when it's half full.
+	 * 			- when the array is reordered (e.g. sorted), build it again by clear() and insert().
+	 */
+	class HashIndex {
+	public:
+		typedef uint32_t key_type;
+		typedef int32_t index_type; // -1 means empty or not found.
+		typedef uint32_t size_type;
+
+	private:
+		struct _slot {
+			key_type key;
+			index_type idx;
+		};
+
+		std::unique_ptr<_slot[]> _t;
+		size_type _mask;
+		size_type _ct;
+
+		static inline uint32_t _hash(key_type k) {
+			// mixes upper bits of serial IDs (e.g. 0x810A.....) into lower bits.
+			k ^= k >> 16;
+			k *= 0x7FEB352DU;
+			k ^= k >> 15;
+			k *= 0x846CA68BU;
+			k ^= k >> 16;
+			return k;
+		}
+
+		void _rehash(size_type sz) {
+			std::unique_ptr<_slot[]> t_old(_t.release());
+			size_type n_old = t_old ? _mask + 1 : 0;
+
+			_t.reset(new _slot[sz]);
+			_mask = sz - 1;
+			for (size_type i = 0; i < sz; i++) _t[i].idx = -1;
+
+			for (size_type i = 0; i < n_old; i++) {
+				if (t_old[i].idx >= 0) {
+					size_type j = _hash(t_old[i].key) & _mask;
+					while (_t[j].idx >= 0) j = (j + 1) & _mask;
+					_t[j] = t_old[i];
+				}
+			}
+		}
+
+	public:
+		HashIndex() : _t(), _mask(0), _ct(0) {}
+
+		HashIndex(size_type n) : HashIndex() {
+			reserve(n);
+		}
+
+		// reserve the table for n keys.
+		void reserve(size_type n) {
+			size_type sz = 16;
+			while (sz < n * 2) sz <<= 1;
+			if (!_t || sz > _mask + 1) _rehash(sz);
+		}
+
+		inline size_type size() const { return _ct; }
+
+		// remove all keys (the table is kept).
+		void clear() {
+			if (_t) for (size_type i = 0; i <= _mask; i++) _t[i].idx = -1;
+			_ct = 0;
+		}
+
+		// returns the index of the key, -1 if not found.
+		index_type find(key_type k) const {
+			if (!_t) return -1;
+
+			for (size_type j = _hash(k) & _mask; _t[j].idx >= 0; j = (j + 1) & _mask) {
+				if (_t[j].key == k) return _t[j].idx;
+			}
+			return -1;
+		}
+
+		// set the index of the key (overwritten if the key exists).
+		void insert(key_type k, index_type idx) {
+			if (!_t || (_ct + 1) * 2 > _mask + 1) reserve(_ct + 1);
+
+			size_type j = _hash(k) & _mask;
+			for (; _t[j].idx >= 0; j = (j + 1) & _mask) {
+				if (_t[j].key == k) {
+					_t[j].idx = idx;
+					return;
+				}
+			}
+
+			_t[j].key = k;
+			_t[j].idx = idx;
+			_ct++;
+		}
+	};
+
+} // TWEUTILS
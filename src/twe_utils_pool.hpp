@@ -0,0 +1,115 @@
+#pragma once
+
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+#include "twe_common.hpp"
+
+#include <memory>
+#include <new>
+
+namespace TWEUTILS {
+	/**
+	 * @class	_FixedSlab
+	 *
+	 * @brief	N slots of S bytes (aligned by A), allocated in constant time.
+	 * 			Unused slots are taken from the top at first, then from the free list.
+	 *
+	 * @tparam	S	size of a slot.
+	 * @tparam	A	alignment of a slot.
+	 * @tparam	N	count of slots.
+	 */
+	template <size_t S, size_t A, size_t N>
+	class _FixedSlab {
+		union _slot {
+			_slot* next;
+			alignas(A) unsigned char buf[S];
+		};
+
+		_slot _slots[N];
+		_slot* _free;
+		size_t _n_bump;
+		size_t _n_used;
+
+	public:
+		_FixedSlab() : _free(nullptr), _n_bump(0), _n_used(0) {}
+
+		inline void* alloc() {
+			_slot* p = nullptr;
+
+			if (_free) {
+				p = _free;
+				_free = p->next;
+			}
+			else if (_n_bump < N) {
+				p = &_slots[_n_bump++];
+			}
+
+			if (p) _n_used++;
+			return p;
+		}
+
+		inline bool dealloc(void* p) {
+			uintptr_t u = reinterpret_cast<uintptr_t>(p);
+			if (u >= reinterpret_cast<uintptr_t>(&_slots[0]) && u < reinterpret_cast<uintptr_t>(&_slots[N])) {
+				_slot* s = static_cast<_slot*>(p);
+				s->next = _free;
+				_free = s;
+				_n_used--;
+				return true;
+			}
+			return false;
+		}
+
+		inline size_t used() const { return _n_used; }
+		inline size_t capacity() const { return N; }
+	};
+
+	/**
+	 * @class	FixedPoolAllocator
+	 *
+	 * @brief	An allocator backed by a static slab of N slots per value type.
+	 * 			Intended for std::allocate_shared(), where the allocator is rebound to
+	 * 			the control block type so that the object and the control block share a slot.
+	 * 			If the slab is exhausted (or n>1), it falls back to operator new.
+	 * 			NOTE: not thread safe, use from a single thread (e.g. the main loop).
+	 *
+	 * @tparam	T	value type.
+	 * @tparam	N	count of slots.
+	 */
+	template <typename T, size_t N>
+	class FixedPoolAllocator {
+	public:
+		typedef T value_type;
+		template <typename U> struct rebind { typedef FixedPoolAllocator<U, N> other; };
+
+		FixedPoolAllocator() noexcept {}
+		template <typename U> FixedPoolAllocator(const FixedPoolAllocator<U, N>&) noexcept {}
+
+		inline T* allocate(size_t n) {
+			if (n == 1) {
+				void* p = slab().alloc();
+				if (p) return static_cast<T*>(p);
+			}
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+
+		inline void deallocate(T* p, size_t n) {
+			if (n == 1 && slab().dealloc(p)) return;
+			::operator delete(p);
+		}
+
+		// the slab dedicated for T.
+		// (allocated at the first use and never destroyed, since objects may be released
+		//  while destructing other static objects.)
+		static _FixedSlab<sizeof(T), alignof(T), N>& slab() {
+			static _FixedSlab<sizeof(T), alignof(T), N>* _slab = new _FixedSlab<sizeof(T), alignof(T), N>();
+			return *_slab;
+		}
+	};
+
+	template <typename T, typename U, size_t N>
+	inline bool operator == (const FixedPoolAllocator<T, N>&, const FixedPoolAllocator<U, N>&) { return true; }
+	template <typename T, typename U, size_t N>
+	inline bool operator != (const FixedPoolAllocator<T, N>&, const FixedPoolAllocator<U, N>&) { return false; }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+#include "twe_common.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace TWEUTILS {
+	/**
+	 * @class	SpscQueue
+	 *
+	 * @brief	A lock-free ring buffer for a single producer thread and a single consumer thread.
+	 * 			- producer side: push()
+	 * 			- consumer side: front(), pop(), pop_front(), peek_since(), clear()
+	 * 			- both sides: empty(), size(), is_full(), capacity(), head_pos()
+	 * 			The capacity is rounded up to a power of 2.
+	 * 			_head/_tail are free-running counters (the index is masked at the access).
+	 *
+	 * @tparam	T	value type.
+	 */
+	template <typename T>
+	class SpscQueue {
+	public:
+		typedef uint32_t size_type;
+		typedef T value_type;
+
+	private:
+		std::unique_ptr<T[]> _p;
+		size_type _mask;
+		std::atomic<size_type> _head; // count of pushed entries (written by the producer)
+		std::atomic<size_type> _tail; // count of popped entries (written by the consumer)
+
+	public:
+		SpscQueue() : _p(), _mask(0), _head(0), _tail(0) {}
+
+		SpscQueue(size_type n) : SpscQueue() {
+			setup(n);
+		}
+
+		// NOTE: not thread safe, call before starting the producer/consumer.
+		void setup(size_type n) {
+			size_type sz = 1;
+			while (sz < n) sz <<= 1;
+
+			_p.reset(new T[sz]);
+			_mask = sz - 1;
+			_head.store(0);
+			_tail.store(0);
+		}
+
+		inline size_type capacity() const {
+			return _p ? _mask + 1 : 0;
+		}
+
+		inline size_type size() const {
+			size_type t = _tail.load(std::memory_order_acquire); // load _tail first, so that _head >= t.
+			return _head.load(std::memory_order_acquire) - t;
+		}
+
+		inline bool empty() const {
+			return size() == 0;
+		}
+
+		inline bool is_full() const {
+			return size() >= capacity();
+		}
+
+		// producer: push an entry, returns false if full.
+		inline bool push(const T& c) {
+			size_type h = _head.load(std::memory_order_relaxed);
+			if (!_p || h - _tail.load(std::memory_order_acquire) > _mask) return false;
+
+			_p[h & _mask] = c;
+			_head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+
+		// producer: push up to n entries, returns count of pushed entries.
+		inline size_type push(const T* p, size_type n) {
+			size_type h = _head.load(std::memory_order_relaxed);
+			size_type room = capacity() - (h - _tail.load(std::memory_order_acquire));
+			size_type ct = (n < room) ? n : room;
+
+			for (size_type i = 0; i < ct; i++) {
+				_p[(h + i) & _mask] = p[i];
+			}
+			_head.store(h + ct, std::memory_order_release);
+
+			return ct;
+		}
+
+		// consumer: the oldest entry (check empty() before calling).
+		inline T& front() {
+			return _p[_tail.load(std::memory_order_relaxed) & _mask];
+		}
+
+		// consumer: remove the oldest entry.
+		inline void pop() {
+			size_type t = _tail.load(std::memory_order_relaxed);
+			if (_head.load(std::memory_order_acquire) != t) {
+				_tail.store(t + 1, std::memory_order_release);
+			}
+		}
+
+		// consumer: pop up to n entries into the array p, returns count of popped entries.
+		inline size_type pop_front(T* p, size_type n) {
+			size_type t = _tail.load(std::memory_order_relaxed);
+			size_type avail = _head.load(std::memory_order_acquire) - t;
+			size_type ct = (n < avail) ? n : avail;
+
+			for (size_type i = 0; i < ct; i++) {
+				p[i] = _p[(t + i) & _mask];
+			}
+			_tail.store(t + ct, std::memory_order_release);
+
+			return ct;
+		}
+
+		/**
+		 * @fn	inline size_type SpscQueue::peek_since(size_type& pos, T* p, size_type n)
+		 *
+		 * @brief	consumer: copy up to n entries pushed after `pos' without popping them.
+		 * 			(e.g. to echo newly arrived data, which is read later.)
+		 *
+		 * @param [in,out]	pos	the free-running position, advanced by the count of copied entries.
+		 * 						if it's older than the oldest entry, starts from the oldest.
+		 * @param [out]   	p  	the destination array.
+		 * @param 		  	n  	the max count of entries to copy.
+		 *
+		 * @returns	count of copied entries.
+		 */
+		inline size_type peek_since(size_type& pos, T* p, size_type n) {
+			size_type t = _tail.load(std::memory_order_relaxed);
+			size_type h = _head.load(std::memory_order_acquire);
+
+			if (int32_t(pos - t) < 0 || int32_t(h - pos) < 0) pos = t;
+
+			size_type avail = h - pos;
+			size_type ct = (n < avail) ? n : avail;
+
+			for (size_type i = 0; i < ct; i++) {
+				p[i] = _p[(pos + i) & _mask];
+			}
+			pos += ct;
+
+			return ct;
+		}
+
+		// the free-running position next to the newest entry (for peek_since()).
+		inline size_type head_pos() const {
+			return _head.load(std::memory_order_acquire);
+		}
+
+		// consumer: discard all entries.
+		inline void clear() {
+			_tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+		}
+	};
+
+} // TWEUTILS
@@ -315,34 +315,194 @@ namespace TWEUTILS {
 		return _SmplBuf_SCompare(s1, s2, [](typename T::value_type x){return x;} );
 	} 
 
-	template <typename T>
-	inline void _SmplBuf_Swap(typename T::iterator a, typename T::iterator b) {
-		typename T::value_type tmp = as_moving(*b);
+	template <typename IT>
+	inline void _SmplBuf_Swap(IT a, IT b) {
+		typename std::remove_reference<decltype(*a)>::type tmp = as_moving(*b);
 		*b = as_moving(*a);
 		*a = as_moving(tmp);
 	}
 
+	/*******************************************************************************
+	 * the sort kernels on iterators (SimpleBuffer<>::iterator or a pointer).
+	 *   - COMP(x, y) is true if x shall be placed after y (the same as the bubble sort
+	 *     used to be, e.g. `x > y' for ascending order).
+	 *   - the values are moved (as_moving()), not copied.
+	 *******************************************************************************/
+
+	// insertion sort [first, last) (stable, for short ranges).
+	template <typename IT, typename TF>
+	void _SmplBuf_InsertionSort(IT first, IT last, TF& COMP) {
+		if (first == last) return;
+
+		for (IT i = first + 1; i != last; ++i) {
+			if (COMP(*(i - 1), *i)) {
+				typename std::remove_reference<decltype(*i)>::type tmp = as_moving(*i);
+				IT j = i;
+				do {
+					*j = as_moving(*(j - 1));
+					j = j - 1;
+				} while (j != first && COMP(*(j - 1), tmp));
+				*j = as_moving(tmp);
+			}
+		}
+	}
+
+	// merge sort [first, last) (stable), buf[] shall have (last - first + 1) / 2 entries at least.
+	template <typename IT, typename V, typename TF>
+	void _SmplBuf_MergeSort(IT first, IT last, V* buf, TF& COMP) {
+		int n = int(last - first);
+		if (n <= 16) {
+			_SmplBuf_InsertionSort(first, last, COMP);
+			return;
+		}
+
+		IT mid = first + (n - n / 2);
+		_SmplBuf_MergeSort(first, mid, buf, COMP);
+		_SmplBuf_MergeSort(mid, last, buf, COMP);
+		if (!COMP(*(mid - 1), *mid)) return; // already in order
+
+		// move the left half to buf[], then merge into [first, last).
+		int nl = int(mid - first);
+		for (int i = 0; i < nl; i++) buf[i] = as_moving(*(first + i));
+
+		V* l = buf;
+		V* l_end = buf + nl;
+		IT r = mid;
+		IT out = first;
+		while (l != l_end && r != last) {
+			if (COMP(*l, *r)) { *out = as_moving(*r); ++r; } // take left if equal (stable)
+			else { *out = as_moving(*l); ++l; }
+			++out;
+		}
+		while (l != l_end) { *out = as_moving(*l); ++l; ++out; }
+	}
+
+	// sift down for heap sort (the largest at the top).
+	template <typename IT, typename TF>
+	void _SmplBuf_SiftDown(IT first, int i, int n, TF& COMP) {
+		while (true) {
+			int c = 2 * i + 1;
+			if (c >= n) break;
+			if (c + 1 < n && COMP(*(first + (c + 1)), *(first + c))) c++;
+			if (!COMP(*(first + c), *(first + i))) break;
+			_SmplBuf_Swap(first + i, first + c);
+			i = c;
+		}
+	}
+
+	// heap sort [first, last) (unstable, the fallback of intro sort).
+	template <typename IT, typename TF>
+	void _SmplBuf_HeapSort(IT first, IT last, TF& COMP) {
+		int n = int(last - first);
+		for (int i = n / 2 - 1; i >= 0; i--) _SmplBuf_SiftDown(first, i, n, COMP);
+		for (int i = n - 1; i > 0; i--) {
+			_SmplBuf_Swap(first, first + i);
+			_SmplBuf_SiftDown(first, 0, i, COMP);
+		}
+	}
+
+	// intro sort [first, last) (unstable), quick sort falling back to heap sort at the depth limit.
+	template <typename IT, typename TF>
+	void _SmplBuf_IntroSort(IT first, IT last, int depth, TF& COMP) {
+		while (last - first > 16) {
+			if (depth-- == 0) {
+				_SmplBuf_HeapSort(first, last, COMP);
+				return;
+			}
+
+			// the median of three to *first as the pivot.
+			IT a = first + 1;
+			IT b = first + int(last - first) / 2;
+			IT c = last - 1;
+			if (COMP(*a, *b)) _SmplBuf_Swap(a, b);
+			if (COMP(*b, *c)) _SmplBuf_Swap(b, c);
+			if (COMP(*a, *b)) _SmplBuf_Swap(a, b);
+			_SmplBuf_Swap(first, b); // *a <= *first <= *c, they stop the scans below.
+
+			// partition: [first + 1, lo) <= pivot <= [lo, last)
+			IT lo = first + 1;
+			IT hi = last;
+			while (true) {
+				while (COMP(*first, *lo)) ++lo;
+				hi = hi - 1;
+				while (COMP(*hi, *first)) hi = hi - 1;
+				if (!(lo - hi < 0)) break;
+				_SmplBuf_Swap(lo, hi);
+				++lo;
+			}
+
+			_SmplBuf_IntroSort(lo, last, depth, COMP);
+			last = lo;
+		}
+
+		_SmplBuf_InsertionSort(first, last, COMP);
+	}
+
+	// apply the permutation (the new a[i] is the old a[idx[i]]) to a[], idx[] is broken.
+	template <typename T, typename S>
+	void _SmplBuf_Permute(T& a, S& b, uint32_t* idx, uint32_t n) {
+		for (uint32_t i = 0; i < n; i++) {
+			if (idx[i] == i) continue;
+
+			typename T::value_type ta = as_moving(a[i]);
+			typename S::value_type tb = as_moving(b[i]);
+			uint32_t j = i;
+			while (idx[j] != i) {
+				uint32_t k = idx[j];
+				a[j] = as_moving(a[k]);
+				b[j] = as_moving(b[k]);
+				idx[j] = j;
+				j = k;
+			}
+			a[j] = as_moving(ta);
+			b[j] = as_moving(tb);
+			idx[j] = j;
+		}
+	}
+
+	/**
+	 * @fn	template <typename T, typename TF> bool SmplBuf_Sort(T& a, TF COMP)
+	 *
+	 * @brief	Sort an array (stable merge sort, O(n log n)).
+	 * 			The order of equal entries is kept (e.g. resorting by another key).
+	 *
+	 * @tparam	T 	Array type (e.g. SimpleBuffer<>).
+	 * @tparam	TF	bool COMP(T::value_type&, T::value_type&), true if the 1st shall be after the 2nd.
+	 * @param [in,out]	a   	The array.
+	 * @param 		  	COMP	The compare function.
+	 *
+	 * @returns	True if it succeeds, false if it's not necessary.
+	 */
 	template <typename T, typename TF>
 	bool SmplBuf_Sort(T& a, TF COMP) {
-		bool b_cond = true;
 		if (a.size() < 2) return false; // not necessary
 
-		// bubble sort...
-		while (b_cond) {
-			auto it_a = a.begin();
-			auto it_a_next = it_a + 1;
+		std::unique_ptr<typename T::value_type[]> buf(new typename T::value_type[(a.size() + 1) / 2]);
+		_SmplBuf_MergeSort(a.begin(), a.end(), buf.get(), COMP);
 
-			b_cond = false;
+		return true;
+	}
 
-			do {
-				if (COMP(*it_a, *it_a_next)) {
-					_SmplBuf_Swap<T>(it_a, it_a_next);
-					b_cond = true;
-				}
+	/**
+	 * @fn	template <typename T, typename TF> bool SmplBuf_Sort_Unstable(T& a, TF COMP)
+	 *
+	 * @brief	Sort an array (intro sort, O(n log n) without extra memory).
+	 * 			The order of equal entries is not defined.
+	 *
+	 * @tparam	T 	Array type (e.g. SimpleBuffer<>).
+	 * @tparam	TF	bool COMP(T::value_type&, T::value_type&), true if the 1st shall be after the 2nd.
+	 * @param [in,out]	a   	The array.
+	 * @param 		  	COMP	The compare function.
+	 *
+	 * @returns	True if it succeeds, false if it's not necessary.
+	 */
+	template <typename T, typename TF>
+	bool SmplBuf_Sort_Unstable(T& a, TF COMP) {
+		if (a.size() < 2) return false; // not necessary
 
-				++it_a; ++it_a_next;
-			} while (it_a_next != a.end());
-		}
+		int depth = 0;
+		for (auto n = a.size(); n > 1; n >>= 1) depth += 2;
+		_SmplBuf_IntroSort(a.begin(), a.end(), depth, COMP);
 
 		return true;
 	}
@@ -354,7 +514,7 @@ namespace TWEUTILS {
 
 	template <typename T>
 	bool SmplBufStrA_Sort(T& a) {
-		return _SmplBuf_Sort(a,
+		return SmplBuf_Sort(a,
 				[](typename T::value_type& x, typename T::value_type& y) {
 					return _SmplBuf_SCompare(x, y) > 0;
 				});
@@ -362,7 +522,7 @@ namespace TWEUTILS {
 
 	template <typename T>
 	bool SmplBufStrA_Sort_NoCase(T& a) {
-		return _SmplBuf_Sort(a,
+		return SmplBuf_Sort(a,
 				[](typename T::value_type& x, typename T::value_type& y) {
 					return _SmplBuf_SCompare(x, y
 						, [](typename T::value_type::value_type z) { return toupper(z); }) > 0;
@@ -384,35 +544,38 @@ namespace TWEUTILS {
 	 */
 	template <typename T, typename S, typename TF>
 	bool _SmplBuf_Sort2(T& a, S& b, TF COMP) {
-		bool b_cond = true;
-		if (a.size() < 2) return false; // not necessary
+		uint32_t n = a.size();
+		if (n < 2) return false; // not necessary
 
-		// bubble sort...
-		while (b_cond) {
-			auto it_a = a.begin();
-			auto it_a_next = it_a + 1;
-			auto it_b = b.begin();
-			auto it_b_next = it_b + 1;
+		// sort the indices of a[] (stable), then move entries of a[] and b[] by the sorted indices.
+		std::unique_ptr<uint32_t[]> idx(new uint32_t[n + (n + 1) / 2]);
+		for (uint32_t i = 0; i < n; i++) idx[i] = i;
 
-			b_cond = false;
+		auto COMP_IDX = [&a, &COMP](uint32_t x, uint32_t y) { return COMP(a[x], a[y]); };
+		_SmplBuf_MergeSort(idx.get(), idx.get() + n, idx.get() + n, COMP_IDX);
 
-			do {
-				if (COMP(*it_a, * it_a_next)) {
-					_SmplBuf_Swap<T>(it_a, it_a_next);
-					_SmplBuf_Swap<S>(it_b, it_b_next);
-					b_cond = true;
-				}
+		_SmplBuf_Permute(a, b, idx.get(), n);
+		return true;
+	}
 
-				++it_a; ++it_a_next;
-				++it_b; ++it_b_next;
-			} while (it_a_next != a.end());
-		}
+	// same as _SmplBuf_Sort2(), the order of equal entries is not defined (no merge buffer).
+	template <typename T, typename S, typename TF>
+	bool _SmplBuf_Sort2_Unstable(T& a, S& b, TF COMP) {
+		uint32_t n = a.size();
+		if (n < 2) return false; // not necessary
+
+		std::unique_ptr<uint32_t[]> idx(new uint32_t[n]);
+		for (uint32_t i = 0; i < n; i++) idx[i] = i;
+
+		SimpleBuffer<uint32_t> v(idx.get(), n, n);
+		SmplBuf_Sort_Unstable(v, [&a, &COMP](uint32_t& x, uint32_t& y) { return COMP(a[x], a[y]); });
 
+		_SmplBuf_Permute(a, b, idx.get(), n);
 		return true;
 	}
 	template <typename T, typename S>
 	bool SmplBuf_Sort2(T& a1, S& a2) {
-		return SmplBuf_Sort2(a1, a2, [](typename T::value_type& a, typename T::value_type& b) {return a > b; });
+		return _SmplBuf_Sort2(a1, a2, [](typename T::value_type& a, typename T::value_type& b) {return a > b; });
 	}
 	/**
 	 * @fn	template <typename T, typename S> bool SmplBuf_Sort2_NoCase(T& a, S& b)
@@ -8,6 +8,7 @@
 #include "twe_utils.hpp"
 #include "twe_utils_unicode.hpp"
 #include "twe_utils_fixedque.hpp"
+#include "twe_utils_hashindex.hpp"
 #include "twe_stream.hpp"
 #include "twe_sercmd.hpp"
 #include "twe_sercmd_ascii.hpp"
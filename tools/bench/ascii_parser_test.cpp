@@ -0,0 +1,125 @@
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+/*
+ * AsciiParser::parse() (twe_sercmd_ascii.cpp):
+ *   - checks the completed payloads against AsciiParser::_u8Parse() byte by byte, the input is split
+ *     into random blocks (lines across blocks), with broken lines (bad char, bad LRC, odd length,
+ *     'X' terminated, garbage between lines).
+ *   - compares the speed with the byte loop on PAL like lines (64 bytes payload), read by 64 bytes (ns/char).
+ * exit code 0: all matched.
+ */
+
+#include "twe_common.hpp"
+#include "twe_sercmd_ascii.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+uint32_t _u32TickCount_ms_on_boot;
+extern "C" void _putchar(char) {}
+
+using namespace TWESERCMD;
+
+// a line of the payload b[] with LRC
+static std::string s_line(const std::vector<uint8_t>& b) {
+	std::string line = ":";
+	char h[4];
+	uint8_t sum = 0;
+	for (auto x : b) {
+		snprintf(h, sizeof(h), "%02X", x);
+		line += h;
+		sum += x;
+	}
+	snprintf(h, sizeof(h), "%02X", uint8_t(-sum));
+	return line + h;
+}
+
+static std::string s_payload(AsciiParser& p) {
+	std::string r;
+	for (auto x : p.get_payload()) r += char(x);
+	return r;
+}
+
+int main() {
+	std::mt19937 rng(3);
+	int n_fail = 0;
+
+	for (int iter = 0; iter < 20000; iter++) {
+		std::string s;
+		int n_lines = 1 + int(rng() % 6);
+		for (int l = 0; l < n_lines; l++) {
+			std::vector<uint8_t> b(1 + rng() % 300);
+			for (auto& x : b) x = uint8_t(rng());
+			std::string line = s_line(b);
+
+			switch (rng() % 8) {
+			case 1: line[1 + rng() % (line.size() - 1)] = 'G'; break; // bad char
+			case 2: line[line.size() - 1] ^= 1; break; // bad LRC
+			case 3: line.erase(line.size() - 1); break; // odd length
+			case 4: line = line.substr(0, line.size() - 2) + "X"; break; // w/o LRC
+			case 5: line += "a"; break; // lower case
+			default: break;
+			}
+			s += line;
+			s += (rng() % 2) ? "\r\n" : "\n";
+			if (rng() % 4 == 0) s += "garbage:12";
+		}
+
+		// reference: byte by byte
+		AsciiParser a(512), b(512);
+		std::vector<std::string> ra, rb;
+		for (unsigned char c : s) {
+			if (b._u8Parse(c) == E_TWESERCMD_COMPLETE) rb.push_back(s_payload(b));
+		}
+
+		// by blocks
+		for (size_t i = 0; i < s.size(); ) {
+			size_t n = 1 + rng() % ((rng() % 2) ? 600 : 70);
+			if (i + n > s.size()) n = s.size() - i;
+			a.parse((const uint8_t*)s.data() + i, n, [&](AsciiParser& p) { ra.push_back(s_payload(p)); });
+			i += n;
+		}
+
+		if (ra != rb) {
+			n_fail++;
+			printf("iter=%d NG (%d/%d lines)\n", iter, int(ra.size()), int(rb.size()));
+		}
+	}
+	printf("check: %s\n", n_fail ? "NG" : "ok");
+
+	// PAL like lines
+	std::string s;
+	for (int l = 0; l < 2000; l++) {
+		std::vector<uint8_t> b(64);
+		for (auto& x : b) x = uint8_t(rng());
+		s += s_line(b) + "\r\n";
+	}
+
+	const int REPS = 20;
+	for (int mode = 0; mode < 2; mode++) {
+		AsciiParser a(512);
+		int ct = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (int r = 0; r < REPS; r++) {
+			if (mode == 0) {
+				for (unsigned char c : s) if (a._u8Parse(c) == E_TWESERCMD_COMPLETE) ct++;
+			}
+			else {
+				for (size_t i = 0; i < s.size(); i += 64) {
+					size_t n = std::min<size_t>(64, s.size() - i);
+					a.parse((const uint8_t*)s.data() + i, n, [&](AsciiParser&) { ct++; });
+				}
+			}
+		}
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / (double(REPS) * s.size());
+		printf("%-22s %6.2f ns/char (%d lines)\n", mode ? "parse() 64B blocks" : "_u8Parse() byte", ns, ct);
+		if (ct != 2000 * REPS) n_fail++;
+	}
+
+	return n_fail ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+/*
+ * CRC8/XOR/LRC kernels (twe_utils_crc8.cpp):
+ *   - checks the results against the byte loops (lengths 0..600, every alignment 0..7).
+ *   - compares the speed with the former byte loops (ns/byte).
+ * exit code 0: all matched.
+ */
+
+#include "twe_utils_crc8.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace TWEUTILS;
+
+// the former byte loops (the CRC table is made bitwise, poly 0x31)
+static uint8_t s_crc_tbl[256];
+static void s_make_crc_tbl() {
+	for (int x = 0; x < 256; x++) {
+		uint8_t c = uint8_t(x);
+		for (int i = 0; i < 8; i++) c = (c & 0x80) ? uint8_t((c << 1) ^ 0x31) : uint8_t(c << 1);
+		s_crc_tbl[x] = c;
+	}
+}
+static uint8_t ref_crc8(const uint8_t* p, size_t n) { uint8_t c = 0; for (size_t i = 0; i < n; i++) c = s_crc_tbl[c ^ p[i]]; return c; }
+static uint8_t ref_xor(const uint8_t* p, size_t n) { uint8_t c = 0; for (size_t i = 0; i < n; i++) c ^= p[i]; return c; }
+static uint8_t ref_lrc(const uint8_t* p, size_t n) { uint8_t c = 0; for (size_t i = 0; i < n; i++) c += p[i]; return uint8_t(~c + 1); }
+
+typedef uint8_t (*fn_ref)(const uint8_t*, size_t);
+typedef uint8_t (*fn_new)(uint8_t*, size_t);
+
+static volatile uint8_t s_sink;
+
+// ns per byte
+template <typename F>
+static double s_time(F f, uint8_t* p, size_t n) {
+	size_t reps = size_t(64 * 1024 * 1024) / (n + 1) + 1;
+	auto t0 = std::chrono::steady_clock::now();
+	uint8_t acc = 0;
+	for (size_t r = 0; r < reps; r++) {
+		p[0] = uint8_t(r); // keep the compiler from hoisting the call
+		acc ^= f(p, n);
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	s_sink = acc;
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(reps * n);
+}
+
+int main() {
+	s_make_crc_tbl();
+
+	std::vector<uint8_t> buf(8 + 4096);
+	srand(1);
+	for (auto& x : buf) x = uint8_t(rand());
+
+	struct { const char* name; fn_ref ref; fn_new fn; } k[] = {
+		{ "CRC8", ref_crc8, CRC8_u8Calc },
+		{ "XOR", ref_xor, XOR_u8Calc },
+		{ "LRC", ref_lrc, LRC_u8Calc },
+	};
+
+	// equivalence
+	int n_err = 0;
+	for (auto& x : k) {
+		for (size_t al = 0; al < 8; al++) {
+			for (size_t n = 0; n <= 600; n++) {
+				if (x.ref(&buf[al], n) != x.fn(&buf[al], n)) {
+					if (n_err++ < 10) printf("MISMATCH %s align=%u len=%u\n", x.name, unsigned(al), unsigned(n));
+				}
+			}
+		}
+	}
+	printf("equivalence: %s\n", n_err ? "NG" : "ok");
+
+	// speed
+	printf("%-5s %6s %12s %12s\n", "", "len", "old ns/B", "new ns/B");
+	for (auto& x : k) {
+		for (size_t n : { size_t(16), size_t(128), size_t(1024) }) {
+			double t_old = s_time(x.ref, &buf[1], n);
+			double t_new = s_time(x.fn, &buf[1], n);
+			printf("%-5s %6u %12.3f %12.3f\n", x.name, unsigned(n), t_old, t_new);
+		}
+	}
+
+	return n_err ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+/*
+ * TweProg firmware writing (twe_firmprog.cpp) against a mock bootloader (flash in memory,
+ * responds at once, so the requests of the window are always in flight):
+ *   - the windowed queue: 1, 2, 4 requests in flight at most, the image is written as is.
+ *   - blocks of all 0xFF are not written (already erased), but verified.
+ *   - differential mode: only the changed sector is erased and rewritten, nothing for the same image.
+ *   - an injected bad block (a bit is flipped at writing) ends in FINISH_ERROR with verify,
+ *     FINISH without verify.
+ * the test image is generated into a temporary file (read through the mapped TweFile).
+ * exit code 0: all matched.
+ */
+
+#include "twe_common.hpp"
+#include "twe_firmprog.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+uint32_t _u32TickCount_ms_on_boot;
+extern "C" void _putchar(char) {}
+extern "C" { const char* twesettings_save_filepath = nullptr; } // used by twe_file.cpp
+namespace TWESYS { void Sleep_ms(int) {} }
+
+using namespace TWE;
+
+static const int BLK = 128;
+static const int SECTOR = 32 * 1024;
+
+// the mock bootloader
+static struct {
+	std::vector<uint8_t> flash;
+	std::deque<std::pair<uint8_t, bool>> rx; // response bytes (true: the last byte of a response)
+	int corrupt_blk;
+	int n_write, n_read, n_erase_all;
+	int n_inflight, n_inflight_max;
+	bool b_write_ff; // a block of all 0xFF is written
+	std::vector<int> sectors; // erased sectors
+
+	void reset(int corrupt) {
+		flash.assign(256 * 1024, 0xFF);
+		rx.clear();
+		corrupt_blk = corrupt;
+		n_write = n_read = n_erase_all = 0;
+		n_inflight = n_inflight_max = 0;
+		b_write_ff = false;
+		sectors.clear();
+	}
+
+	// len, data..., xor
+	void respond(std::vector<uint8_t> r) {
+		r.insert(r.begin(), uint8_t(r.size() + 1));
+		uint8_t x = 0;
+		for (auto c : r) x ^= c;
+		r.push_back(x);
+		for (size_t i = 0; i < r.size(); i++) rx.push_back({ r[i], i + 1 == r.size() });
+	}
+} s_mock;
+
+struct MockBl : public ITweBlProtocol {
+	void setup() {}
+	bool connect() { return true; }
+	bool change_baud(int) { return true; }
+	bool reset_module() { return true; }
+	bool setpin(bool) { return true; }
+
+	void serial_write(const char* s, int len) {
+		const uint8_t* p = (const uint8_t*)s;
+		uint32_t a = p[2] | (p[3] << 8) | (p[4] << 16) | (uint32_t(p[5]) << 24);
+
+		s_mock.n_inflight++;
+		s_mock.n_inflight_max = std::max(s_mock.n_inflight_max, s_mock.n_inflight);
+
+		switch (p[1]) {
+		case 0x27: s_mock.respond({ 0x28, 0 }); break; // baud
+		case 0x32: s_mock.respond({ 0x33, 0, 0, 0, 0x86, 0x86 }); break; // chip id
+		case 0x25: s_mock.respond({ 0x26, 0, 0xCC, 0xEE }); break; // mac addr
+		case 0x2C: s_mock.respond({ 0x2D, 0 }); break; // select flash
+		case 0x07: // erase all
+			std::fill(s_mock.flash.begin(), s_mock.flash.end(), 0xFF);
+			s_mock.n_erase_all++;
+			s_mock.respond({ 0x08, 0 });
+			break;
+		case 0x0D: // erase sector
+			std::fill(s_mock.flash.begin() + p[2] * SECTOR, s_mock.flash.begin() + (p[2] + 1) * SECTOR, 0xFF);
+			s_mock.sectors.push_back(p[2]);
+			s_mock.respond({ 0x0E, 0 });
+			break;
+		case 0x09: { // write (bits are cleared only)
+			int n = len - 7;
+			bool b_ff = true;
+			for (int i = 0; i < n; i++) {
+				s_mock.flash[a + i] &= p[6 + i];
+				if (p[6 + i] != 0xFF) b_ff = false;
+			}
+			if (b_ff) s_mock.b_write_ff = true;
+			if (int(a / BLK) == s_mock.corrupt_blk) s_mock.flash[a] ^= 0x01;
+			s_mock.n_write++;
+			s_mock.respond({ 0x0A, 0 });
+			break; }
+		case 0x0B: { // read
+			int n = p[6] | (p[7] << 8);
+			std::vector<uint8_t> r{ 0x0C, 0 };
+			r.insert(r.end(), s_mock.flash.begin() + a, s_mock.flash.begin() + a + n);
+			s_mock.n_read++;
+			s_mock.respond(r);
+			break; }
+		}
+	}
+};
+
+TweProg TWE::twe_prog(new MockBl());
+
+// the test image (header 4 bytes + data), blocks 10..19 and sector 2 (partly) are all 0xFF.
+static std::vector<uint8_t> s_image() {
+	std::mt19937 rng(7);
+	std::vector<uint8_t> d(4 + 90000);
+	for (auto& x : d) x = uint8_t(rng());
+	std::fill(d.begin() + 4 + 10 * BLK, d.begin() + 4 + 20 * BLK, 0xFF);
+	std::fill(d.begin() + 4 + 2 * SECTOR, d.begin() + 4 + 2 * SECTOR + 40 * BLK, 0xFF);
+	return d;
+}
+
+static const char* s_tmpfile;
+static std::vector<uint8_t> s_img;
+
+static bool s_image_ok() {
+	return memcmp(s_mock.flash.data(), s_img.data() + 4, s_img.size() - 4) == 0;
+}
+
+// runs the protocol to the end, returns the final state.
+static TweProg::E_ST_TWEBLP s_run(int n_window, bool b_diff, bool b_verify) {
+	auto f = std::make_shared<TweFile>();
+	TWEUTILS::SmplBuf_WChar name;
+	for (const char* q = s_tmpfile; *q; q++) name.push_back(wchar_t(*q));
+	if (!f->open(name)) {
+		printf("cannot open %s\n", s_tmpfile);
+		exit(1);
+	}
+
+	TweProg& tp = twe_prog;
+	tp.set_firmware_data(f);
+	tp.set_write_window(uint8_t(n_window));
+	tp.rewind_firmware_data();
+	tp.clear_state();
+	tp.begin(TweProg::write_protocol(b_diff, b_verify));
+
+	bool b_done = false;
+	while (!b_done) {
+		int c = -1;
+		if (!s_mock.rx.empty()) {
+			c = s_mock.rx.front().first;
+			if (s_mock.rx.front().second) s_mock.n_inflight--;
+			s_mock.rx.pop_front();
+		}
+		b_done = tp.process_input(c);
+	}
+	return tp.get_state();
+}
+
+static int n_fail = 0;
+
+static void s_check(const char* name, bool b) {
+	printf("%-40s %s\n", name, b ? "ok" : "NG");
+	if (!b) n_fail++;
+}
+
+int main() {
+	s_img = s_image();
+	// blocks (as TweProg, the rest is padded with 0xFF) and blocks of all 0xFF
+	int n_blk = int((s_img.size() - 4) / BLK) + 1;
+	auto is_ff = [](int n) {
+		for (int i = 0; i < BLK; i++) {
+			size_t j = 4 + size_t(n) * BLK + i;
+			if (j < s_img.size() && s_img[j] != 0xFF) return false;
+		}
+		return true;
+	};
+	int n_blk_ff = 0, n_blk_ff_s0 = 0, n_blk_ff_s2 = 0;
+	for (int n = 0; n < n_blk; n++) {
+		if (!is_ff(n)) continue;
+		n_blk_ff++;
+		if (n / (SECTOR / BLK) == 0) n_blk_ff_s0++;
+		if (n / (SECTOR / BLK) == 2) n_blk_ff_s2++;
+	}
+
+	static char tmpl[] = "/tmp/firmprog_test_XXXXXX";
+	int fd = mkstemp(tmpl);
+	if (fd < 0) return 1;
+	FILE* fp = fdopen(fd, "wb");
+	fwrite(s_img.data(), 1, s_img.size(), fp);
+	fclose(fp);
+	s_tmpfile = tmpl;
+
+	// the windowed queue
+	for (int w : { 1, 2, 4 }) {
+		std::string name = "full/window " + std::to_string(w);
+		s_mock.reset(-1);
+		TweProg::E_ST_TWEBLP st = s_run(w, false, true);
+		s_check(name.c_str(), st == TweProg::E_ST_TWEBLP::FINISH && s_image_ok() && s_mock.n_erase_all == 1
+			&& s_mock.n_inflight_max == w);
+
+		// blocks of all 0xFF: not written, but verified
+		if (w == 1) {
+			printf("  writes=%d reads=%d (blocks=%d, 0xFF=%d)\n", s_mock.n_write, s_mock.n_read, n_blk, n_blk_ff);
+			s_check("full/skip 0xFF blocks", !s_mock.b_write_ff && s_mock.n_write == n_blk - n_blk_ff
+				&& s_mock.n_read == n_blk);
+		}
+	}
+
+	// from garbage
+	s_mock.reset(-1);
+	for (size_t i = 0; i < s_mock.flash.size(); i++) s_mock.flash[i] = uint8_t(i * 7);
+	s_check("full/garbage", s_run(4, false, true) == TweProg::E_ST_TWEBLP::FINISH && s_image_ok());
+
+	// differential: the same image
+	s_mock.reset(-1);
+	memcpy(s_mock.flash.data(), s_img.data() + 4, s_img.size() - 4);
+	s_check("diff/same image", s_run(4, true, true) == TweProg::E_ST_TWEBLP::FINISH && s_image_ok()
+		&& s_mock.n_write == 0 && s_mock.sectors.empty() && s_mock.n_erase_all == 0);
+
+	// differential: a byte changed in the sector 1 (the dirty sector mask)
+	s_mock.reset(-1);
+	memcpy(s_mock.flash.data(), s_img.data() + 4, s_img.size() - 4);
+	s_mock.flash[SECTOR + 1000] ^= 0x5A;
+	s_check("diff/sector 1 changed", s_run(4, true, true) == TweProg::E_ST_TWEBLP::FINISH && s_image_ok()
+		&& s_mock.sectors == std::vector<int>{ 1 } && s_mock.n_write == SECTOR / BLK && !s_mock.b_write_ff);
+
+	// differential: sector 0 (with the 0xFF blocks) and 2 changed
+	s_mock.reset(-1);
+	memcpy(s_mock.flash.data(), s_img.data() + 4, s_img.size() - 4);
+	s_mock.flash[100] ^= 0x01;
+	s_mock.flash[2 * SECTOR + 60 * BLK] ^= 0x01;
+	s_check("diff/sector 0,2 changed", s_run(2, true, true) == TweProg::E_ST_TWEBLP::FINISH && s_image_ok()
+		&& s_mock.sectors == std::vector<int>{ 0, 2 } && !s_mock.b_write_ff
+		&& s_mock.n_write == (SECTOR / BLK - n_blk_ff_s0) + (n_blk - 2 * SECTOR / BLK - n_blk_ff_s2));
+
+	// a bad block
+	s_mock.reset(300);
+	s_check("full/bad block, verify", s_run(4, false, true) == TweProg::E_ST_TWEBLP::FINISH_ERROR);
+	s_mock.reset(300);
+	s_check("full/bad block, no verify", s_run(4, false, false) == TweProg::E_ST_TWEBLP::FINISH && !s_image_ok());
+	s_mock.reset(300);
+	memcpy(s_mock.flash.data(), s_img.data() + 4, s_img.size() - 4);
+	s_mock.flash[300 * BLK + 5] ^= 0x01;
+	s_check("diff/bad block, verify", s_run(1, true, true) == TweProg::E_ST_TWEBLP::FINISH_ERROR);
+
+	remove(tmpl);
+	printf("check: %s\n", n_fail ? "NG" : "ok");
+	return n_fail ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+/*
+ * LCD to texture row kernels (gen/sdl2_pixkern.hpp):
+ *   - checks pixkern::row_x1/row_x2 are bit exact with pixkern_ref:: for
+ *     lengths 0..333, source offsets 0..3 and all dimming levels.
+ *   - compares the speed of a 320 pixel row.
+ * exit code 0: all matched.
+ */
+
+#include "gen/sdl2_pixkern.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace TWEARD;
+
+#if defined(MWM5_PIXKERN_SSE2)
+static const char* KERN_NAME = "SSE2";
+#elif defined(MWM5_PIXKERN_NEON)
+static const char* KERN_NAME = "NEON";
+#else
+static const char* KERN_NAME = "scalar";
+#endif
+
+static const int N_MAX = 333;
+static const int GUARD = 8; // texels after the row, must not be touched
+
+static int s_n_err = 0;
+
+static void s_check(const char* name, const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, int n, int off, int l0, int l1) {
+	if (memcmp(a.data(), b.data(), a.size() * sizeof(uint32_t)) != 0) {
+		if (s_n_err++ < 10) printf("MISMATCH %s len=%d off=%d lumi=%d,%d\n", name, n, off, l0, l1);
+	}
+}
+
+static volatile uint32_t s_sink;
+
+// ns per row
+template <typename F>
+static double s_time(F f) {
+	const int reps = 200000;
+	auto t0 = std::chrono::steady_clock::now();
+	for (int r = 0; r < reps; r++) f(r);
+	auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / reps;
+}
+
+int main() {
+	std::vector<RGBA> src(N_MAX + 4);
+	srand(1);
+	for (auto& c : src) c.u32col = uint32_t(rand()) ^ (uint32_t(rand()) << 16);
+
+	std::vector<uint32_t> d_ref(2 * N_MAX + GUARD), d_new(2 * N_MAX + GUARD);
+	const int l1s[] = { 0, 1, 0x7F, 0x80, 0xFE, 0xFF };
+
+	for (int off = 0; off < 4; off++) {
+		for (int n = 0; n <= N_MAX; n++) {
+			for (int l0 = 0; l0 < 256; l0++) {
+				// x1
+				std::fill(d_ref.begin(), d_ref.end(), 0x5A5A5A5A);
+				std::fill(d_new.begin(), d_new.end(), 0x5A5A5A5A);
+				pixkern_ref::row_x1(d_ref.data(), &src[off], n, uint8_t(l0));
+				pixkern::row_x1(d_new.data(), &src[off], n, uint8_t(l0));
+				s_check("row_x1", d_ref, d_new, n, off, l0, l0);
+
+				// x2 (same dimming, and the other one)
+				for (int l1 : l1s) {
+					for (int b_same = 0; b_same < 2; b_same++) {
+						if (b_same) l1 = l0;
+						std::fill(d_ref.begin(), d_ref.end(), 0x5A5A5A5A);
+						std::fill(d_new.begin(), d_new.end(), 0x5A5A5A5A);
+						pixkern_ref::row_x2(d_ref.data(), &src[off], n, uint8_t(l0), uint8_t(l1));
+						pixkern::row_x2(d_new.data(), &src[off], n, uint8_t(l0), uint8_t(l1));
+						s_check("row_x2", d_ref, d_new, n, off, l0, l1);
+					}
+				}
+			}
+		}
+	}
+	printf("kernel: %s, bit exact: %s\n", KERN_NAME, s_n_err ? "NG" : "ok");
+
+	// speed (320 pixels)
+	const int W = 320;
+	uint32_t* d = d_new.data();
+	printf("%-18s %10s %10s\n", "320px row", "ref ns", "new ns");
+	printf("%-18s %10.1f %10.1f\n", "x1",
+		s_time([&](int r) { pixkern_ref::row_x1(d, &src[0], W); s_sink = d[r % W]; }),
+		s_time([&](int r) { pixkern::row_x1(d, &src[0], W); s_sink = d[r % W]; }));
+	printf("%-18s %10.1f %10.1f\n", "x1 dimmed",
+		s_time([&](int r) { pixkern_ref::row_x1(d, &src[0], W, 0xC0); s_sink = d[r % W]; }),
+		s_time([&](int r) { pixkern::row_x1(d, &src[0], W, 0xC0); s_sink = d[r % W]; }));
+	printf("%-18s %10.1f %10.1f\n", "x2 (lcd mode)",
+		s_time([&](int r) { pixkern_ref::row_x2(d, &src[0], W, 0xFF, 0xC0); s_sink = d[r % W]; }),
+		s_time([&](int r) { pixkern::row_x2(d, &src[0], W, 0xFF, 0xC0); s_sink = d[r % W]; }));
+
+	return s_n_err ? 1 : 0;
+}
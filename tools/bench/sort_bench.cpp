@@ -0,0 +1,147 @@
+/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */
+
+/*
+ * SmplBuf_Sort family (twe_utils_unicode.hpp):
+ *   - checks SmplBuf_Sort/SmplBufStrA_Sort2 against std::stable_sort (same order of equal keys),
+ *     and SmplBuf_Sort_Unstable/_SmplBuf_Sort2_Unstable against std::sort (sorted, a permutation).
+ *     (random, ascending, descending, few distinct keys; n = 0..3000)
+ *   - compares the speed with the former bubble sort on 1000..10000 entries (ms),
+ *     and the stable/unstable sort of two arrays of file name like strings (as TWE_ListView).
+ * exit code 0: all matched.
+ */
+
+#include "twe_common.hpp"
+#include "twe_utils.hpp"
+#include "twe_utils_simplebuffer.hpp"
+#include "twe_utils_unicode.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+uint32_t _u32TickCount_ms_on_boot;
+extern "C" void _putchar(char) {}
+
+using namespace TWEUTILS;
+
+struct ent { int key; int seq; };
+typedef std::shared_ptr<ent> spEnt;
+
+// the former bubble sort
+template <typename T, typename TF>
+static void ref_bubble(T& a, TF COMP) {
+	if (a.size() < 2) return;
+	bool b_swapped = true;
+	while (b_swapped) {
+		b_swapped = false;
+		auto x = a.begin(), y = x + 1;
+		do {
+			if (COMP(*x, *y)) { _SmplBuf_Swap(x, y); b_swapped = true; }
+			++x; ++y;
+		} while (y != a.end());
+	}
+}
+
+static std::wstring s_wstr(SmplBuf_WChar& w) { return std::wstring(w.begin().raw_ptr(), w.size()); }
+
+static double s_ms(std::chrono::steady_clock::time_point t0) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main() {
+	std::mt19937 rng(1);
+	auto COMP = [](spEnt& x, spEnt& y) { return x->key > y->key; };
+	auto COMP_STR = [](SmplBuf_WChar& x, SmplBuf_WChar& y) { return _SmplBuf_SCompare(x, y) > 0; };
+	int n_fail = 0;
+
+	for (int iter = 0; iter < 3000; iter++) {
+		int n = iter < 2000 ? int(rng() % 70) : int(rng() % 3000);
+		int range = 1 + int(rng() % (iter % 3 == 0 ? 4 : 100000));
+		int pattern = int(rng() % 4);
+
+		SimpleBuffer<spEnt> a, u;
+		std::vector<ent> ref;
+		SimpleBuffer<SmplBuf_WChar> s1, t1;
+		SimpleBuffer<int> s2, t2;
+		std::vector<std::pair<std::wstring, int>> ref2;
+		std::vector<std::wstring> orig;
+
+		for (int i = 0; i < n; i++) {
+			int k = pattern == 1 ? i : pattern == 2 ? n - i : pattern == 3 ? i % 7 : int(rng() % range);
+			a.push_back(spEnt(new ent{ k, i }));
+			u.push_back(spEnt(new ent{ k, i }));
+			ref.push_back(ent{ k, i });
+
+			SmplBuf_WChar w;
+			w << wchar_t('a' + k % 26) << wchar_t('A' + (k / 26) % 26);
+			s1.push_back(w); s2.push_back(i);
+			t1.push_back(w); t2.push_back(i);
+			ref2.push_back({ s_wstr(w), i });
+			orig.push_back(s_wstr(w));
+		}
+
+		// stable: same as std::stable_sort
+		SmplBuf_Sort(a, COMP);
+		std::stable_sort(ref.begin(), ref.end(), [](const ent& x, const ent& y) { return x.key < y.key; });
+		for (int i = 0; i < n; i++) {
+			if (a[i]->key != ref[i].key || a[i]->seq != ref[i].seq) { n_fail++; printf("SmplBuf_Sort n=%d NG\n", n); break; }
+		}
+
+		SmplBufStrA_Sort2(s1, s2);
+		std::stable_sort(ref2.begin(), ref2.end(),
+			[](const std::pair<std::wstring, int>& x, const std::pair<std::wstring, int>& y) { return x.first < y.first; });
+		for (int i = 0; i < n; i++) {
+			if (s_wstr(s1[i]) != ref2[i].first || s2[i] != ref2[i].second) { n_fail++; printf("SmplBufStrA_Sort2 n=%d NG\n", n); break; }
+		}
+
+		// unstable: the keys are in order of std::sort, entries are a permutation
+		SmplBuf_Sort_Unstable(u, COMP);
+		std::vector<int> seqs;
+		for (int i = 0; i < n; i++) {
+			if (u[i]->key != ref[i].key) { n_fail++; printf("SmplBuf_Sort_Unstable n=%d NG\n", n); break; }
+			seqs.push_back(u[i]->seq);
+		}
+		std::sort(seqs.begin(), seqs.end());
+		for (int i = 0; i < int(seqs.size()); i++) {
+			if (seqs[i] != i) { n_fail++; printf("SmplBuf_Sort_Unstable n=%d lost entries\n", n); break; }
+		}
+
+		_SmplBuf_Sort2_Unstable(t1, t2, COMP_STR);
+		for (int i = 0; i < n; i++) {
+			if (s_wstr(t1[i]) != ref2[i].first || s_wstr(t1[i]) != orig[t2[i]]) { n_fail++; printf("_SmplBuf_Sort2_Unstable n=%d NG\n", n); break; }
+		}
+	}
+	printf("check: %s\n", n_fail ? "NG" : "ok");
+
+	printf("%6s %12s %10s %10s %14s %14s\n", "n", "bubble[ms]", "merge[ms]", "intro[ms]", "sort2 str[ms]", "unstable[ms]");
+	for (int n : { 1000, 3000, 10000 }) {
+		SimpleBuffer<spEnt> base, a;
+		for (int i = 0; i < n; i++) base.push_back(spEnt(new ent{ int(rng() % 1000), i }));
+
+		a = base; auto t0 = std::chrono::steady_clock::now(); ref_bubble(a, COMP); double t_bubble = s_ms(t0);
+		a = base; t0 = std::chrono::steady_clock::now(); SmplBuf_Sort(a, COMP); double t_merge = s_ms(t0);
+		a = base; t0 = std::chrono::steady_clock::now(); SmplBuf_Sort_Unstable(a, COMP); double t_intro = s_ms(t0);
+
+		// file name like list (as TWE_ListView)
+		SimpleBuffer<SmplBuf_WChar> f, g, f2, g2;
+		for (int i = 0; i < n; i++) {
+			char b[32];
+			snprintf(b, sizeof(b), "FW_%08x.bin", unsigned(rng()));
+			SmplBuf_WChar w;
+			for (char* p = b; *p; p++) w << wchar_t(*p);
+			f.push_back(w); g.push_back(w);
+			f2.push_back(w); g2.push_back(w);
+		}
+		t0 = std::chrono::steady_clock::now(); SmplBufStrA_Sort2_NoCase(f, g); double t_sort2 = s_ms(t0);
+		t0 = std::chrono::steady_clock::now(); _SmplBuf_Sort2_Unstable(f2, g2, COMP_STR); double t_sort2u = s_ms(t0);
+
+		printf("%6d %12.2f %10.3f %10.3f %14.3f %14.3f\n", n, t_bubble, t_merge, t_intro, t_sort2, t_sort2u);
+	}
+
+	return n_fail ? 1 : 0;
+}
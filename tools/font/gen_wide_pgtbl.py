@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+# Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.
+# Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+#
+# Generates the page tables of wide chars (TWEFONT::FontWidePageTable) from
+# the index tables (const uint16_t font_..._idx[N] = {...}) in src/font/lcd_font_*_table.src.
+#   src/font/lcd_font_XXX_table.src -> src/font/lcd_font_XXX_pgtbl.src
+#   the table of font_..._idx[] is named font_..._idx_pgtbl (const, placed in flash on ESP32).
+#
+# usage: tools/font/gen_wide_pgtbl.py [src/font]
+
+import glob
+import os
+import re
+import sys
+
+RE_IDX = re.compile(r'const\s+uint16_t\s+(\w+_idx\w*)\s*\[\s*(\w+)\s*\]\s*=\s*\{(.*?)\};', re.S)
+
+
+def popcount(v):
+    return bin(v).count('1')
+
+
+def gen_table(name, codes):
+    assert codes == sorted(codes) and len(set(codes)) == len(codes), name + ' is not sorted'
+
+    hi_list = []
+    bits = {}
+    for c in codes:
+        hi = c >> 8
+        if hi not in bits:
+            hi_list.append(hi)
+            bits[hi] = [0] * 8
+        bits[hi][(c >> 5) & 7] |= 1 << (c & 31)
+
+    out = []
+    out.append('\t// page table of %s[] (%d pages)' % (name, len(hi_list)))
+    out.append('\tstatic const FontWidePageTable::page %s_pages[%d] = {' % (name, len(hi_list)))
+    base = 0
+    for hi in hi_list:
+        b = bits[hi]
+        bases = []
+        for w in b:
+            bases.append(base)
+            base += popcount(w)
+        out.append('\t\t{ { %s }, { %s } }, // %02Xxx' % (
+            ', '.join('0x%08x' % w for w in b),
+            ', '.join('%d' % x for x in bases),
+            hi))
+    out.append('\t};')
+
+    d = [-1] * 256
+    for i, hi in enumerate(hi_list):
+        d[hi] = i
+    out.append('\tconst FontWidePageTable %s_pgtbl = {' % name)
+    out.append('\t\t%s,' % name)
+    out.append('\t\t{')
+    for i in range(0, 256, 16):
+        out.append('\t\t\t%s,' % ', '.join('%3d' % x for x in d[i:i + 16]))
+    out.append('\t\t},')
+    out.append('\t\t%s_pages' % name)
+    out.append('\t};')
+    return out
+
+
+def main():
+    font_dir = os.path.normpath(sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(__file__), '..', '..', 'src', 'font'))
+
+    for src in sorted(glob.glob(os.path.join(font_dir, 'lcd_font_*_table.src'))):
+        text = open(src, encoding='utf-8', errors='replace').read()
+        tables = RE_IDX.findall(text)
+        if not tables:
+            continue
+
+        out = []
+        out.append('/* Copyright (C) 2019-2020 Mono Wireless Inc. All Rights Reserved.')
+        out.append(' * Released under MW-OSSLA-1J,1E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT). */')
+        out.append('')
+        out.append('/* generated by tools/font/gen_wide_pgtbl.py from %s, do not edit. */' % os.path.basename(src))
+        out.append('')
+        out.append('namespace TWEFONT {')
+        for name, _, body in tables:
+            codes = [int(x, 16) for x in re.findall(r'0x[0-9a-fA-F]+', body)]
+            out += gen_table(name, codes)
+            out.append('')
+        out.append('}')
+
+        dst = src.replace('_table.src', '_pgtbl.src')
+        with open(dst, 'w', newline='\n') as f:
+            f.write('\n'.join(out) + '\n')
+        print(dst)
+
+
+if __name__ == '__main__':
+    main()